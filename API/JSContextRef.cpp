@@ -29,6 +29,7 @@
 
 #include "APICast.h"
 #include "CallFrame.h"
+#include "GCTelemetry.h"
 #include "InitializeThreading.h"
 #include "JSAPIGlobalObject.h"
 #include "JSAPIWrapperObject.h"
@@ -112,6 +113,62 @@ void JSContextGroupClearExecutionTimeLimit(JSContextGroupRef group)
         vm.watchdog()->setTimeLimit(Watchdog::noTimeLimit);
 }
 
+size_t JSContextGroupCopyGarbageCollectionRecords(JSContextGroupRef group, JSGarbageCollectionRecord* records, size_t capacity)
+{
+    if (!group || (!records && capacity)) {
+        ASSERT_NOT_REACHED();
+        return 0;
+    }
+
+    // GCTelemetry is safe to read without the API lock, which lets embedders sample it from a
+    // monitoring thread.
+    VM& vm = *toJS(group);
+    Vector<GCTelemetryRecord> telemetry = vm.heap.gcTelemetry().copyRecords();
+    size_t count = std::min(capacity, telemetry.size());
+    size_t first = telemetry.size() - count;
+    for (size_t i = 0; i < count; ++i) {
+        const GCTelemetryRecord& record = telemetry[first + i];
+        JSGarbageCollectionRecord& result = records[i];
+        result.collectionID = record.collectionID;
+        result.isFullCollection = record.scope == CollectionScope::Full;
+        result.startTime = record.startTime.secondsSinceEpoch().milliseconds();
+        result.duration = record.duration.milliseconds();
+        result.totalPauseTime = record.totalPauseTime.milliseconds();
+        result.maxPauseTime = record.maxPauseTime.milliseconds();
+        result.beginPhaseTime = record.phaseTime(CollectorPhase::Begin).milliseconds();
+        result.fixpointPhaseTime = record.phaseTime(CollectorPhase::Fixpoint).milliseconds();
+        result.concurrentPhaseTime = record.phaseTime(CollectorPhase::Concurrent).milliseconds();
+        result.reloopPhaseTime = record.phaseTime(CollectorPhase::Reloop).milliseconds();
+        result.endPhaseTime = record.phaseTime(CollectorPhase::End).milliseconds();
+        result.constraintSolvingTime = record.constraintSolvingTime.milliseconds();
+        result.bytesVisited = record.bytesVisited;
+        result.heapSizeAfterCollection = record.heapSizeAfterCollection;
+        result.blocksSweptSinceLastCollection = record.blocksSweptSinceLastCollection;
+    }
+    return count;
+}
+
+JSStringRef JSContextGroupCopyGarbageCollectionRecordsJSON(JSContextGroupRef group)
+{
+    if (!group) {
+        ASSERT_NOT_REACHED();
+        return nullptr;
+    }
+    VM& vm = *toJS(group);
+    return OpaqueJSString::tryCreate(vm.heap.gcTelemetry().toJSON()).leakRef();
+}
+
+void JSContextGroupPerformIdleWork(JSContextGroupRef group, double milliseconds)
+{
+    if (!group) {
+        ASSERT_NOT_REACHED();
+        return;
+    }
+    VM& vm = *toJS(group);
+    JSLockHolder locker(&vm);
+    vm.heap.performIdleWork(Seconds::fromMilliseconds(milliseconds));
+}
+
 // From the API's perspective, a global context remains alive iff it has been JSGlobalContextRetained.
 
 JSGlobalContextRef JSGlobalContextCreate(JSClassRef globalObjectClass)
@@ -29,6 +29,8 @@
 #include <JavaScriptCore/JSObjectRef.h>
 #include <JavaScriptCore/JSValueRef.h>
 #include <JavaScriptCore/WebKitAvailability.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #ifndef __cplusplus
 #include <stdbool.h>
@@ -138,6 +140,71 @@ JS_EXPORT void JSGlobalContextSetIncludesNativeCallStackWhenReportingExceptions(
 */
 JS_EXPORT void JSGlobalContextSetUnhandledRejectionCallback(JSGlobalContextRef ctx, JSObjectRef function, JSValueRef* exception) JSC_API_AVAILABLE(macos(10.15.4), ios(13.4));
 
+/*!
+@struct JSGarbageCollectionRecord
+@abstract Timings and statistics for one completed garbage collection. All times are in milliseconds.
+@field collectionID Increases by one with every collection of the context group, starting at 1.
+@field isFullCollection Whether this was a full collection rather than an eden collection.
+@field startTime When the collection started, on the monotonic clock.
+@field duration Time from the start of the collection to its end, including concurrent marking.
+@field totalPauseTime Total time the collection kept the mutator stopped.
+@field maxPauseTime Longest single time the collection kept the mutator stopped.
+@field beginPhaseTime Time spent in the collector's Begin phase.
+@field fixpointPhaseTime Time spent in the collector's Fixpoint phases, with the mutator stopped.
+@field concurrentPhaseTime Time spent in the collector's Concurrent phases, with the mutator running.
+@field reloopPhaseTime Time spent in the collector's Reloop phases.
+@field endPhaseTime Time spent in the collector's End phase.
+@field constraintSolvingTime Time spent executing marking constraints, included in fixpointPhaseTime.
+@field bytesVisited Bytes visited by the marking threads.
+@field heapSizeAfterCollection Heap size in bytes once the collection finished.
+@field blocksSweptSinceLastCollection Number of heap blocks swept between the previous collection and this one.
+*/
+typedef struct {
+    uint64_t collectionID;
+    bool isFullCollection;
+    double startTime;
+    double duration;
+    double totalPauseTime;
+    double maxPauseTime;
+    double beginPhaseTime;
+    double fixpointPhaseTime;
+    double concurrentPhaseTime;
+    double reloopPhaseTime;
+    double endPhaseTime;
+    double constraintSolvingTime;
+    size_t bytesVisited;
+    size_t heapSizeAfterCollection;
+    size_t blocksSweptSinceLastCollection;
+} JSGarbageCollectionRecord;
+
+/*!
+@function
+@abstract Copies records for the most recent garbage collections of a context group.
+@discussion The number of collections remembered is controlled by the numberOfGCTelemetryRecords option. This does not take the JavaScript lock and never waits for the collector, so it is safe to call from any thread while the group is alive.
+@param group The JSContextGroup whose collections you want to inspect.
+@param records A buffer to fill with records, oldest first.
+@param capacity The number of records that fit in records. If fewer records fit than are available, the most recent ones are copied.
+@result The number of records copied.
+*/
+JS_EXPORT size_t JSContextGroupCopyGarbageCollectionRecords(JSContextGroupRef group, JSGarbageCollectionRecord* records, size_t capacity) JSC_API_AVAILABLE(macos(12.0), ios(15.0));
+
+/*!
+@function
+@abstract Same as JSContextGroupCopyGarbageCollectionRecords, but returns the records as a JSON array.
+@param group The JSContextGroup whose collections you want to inspect.
+@result A JSString containing the JSON. The caller must release it.
+*/
+JS_EXPORT JSStringRef JSContextGroupCopyGarbageCollectionRecordsJSON(JSContextGroupRef group) JSC_API_AVAILABLE(macos(12.0), ios(15.0));
+
+/*!
+@function
+@abstract Lets the garbage collector use time in which the embedder has no script to run.
+@param group The JSContextGroup whose heap should do the work.
+@param milliseconds How long the embedder expects to stay idle.
+@discussion The heap helps along a collection that is in progress, keeping the mutator stopped so that marking can use every collector thread. If there is time left and a collection is due soon, it starts one, but only if the last collection of its kind took less than the time left. Then it sweeps. Old code is jettisoned by the collections themselves. The call returns when the time is up, or earlier if there is no work left. Call it from a thread that may use the group, between script executions.
+*/
+JS_EXPORT void JSContextGroupPerformIdleWork(JSContextGroupRef group, double milliseconds) JSC_API_AVAILABLE(macos(12.0), ios(15.0));
+
 #ifdef __cplusplus
 }
 #endif
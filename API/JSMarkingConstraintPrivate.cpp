@@ -27,7 +27,10 @@
 #include "JSMarkingConstraintPrivate.h"
 
 #include "APICast.h"
+#include "MarkingConstraintSet.h"
+#include "PreventCollectionScope.h"
 #include "SimpleMarkingConstraint.h"
+#include <wtf/Box.h>
 
 using namespace JSC;
 
@@ -55,6 +58,15 @@ void mark(JSMarkerRef markerRef, JSObjectRef objectRef)
     static_cast<Marker*>(markerRef)->visitor->appendHiddenUnbarriered(toJS(objectRef));
 }
 
+Marker makeMarker(SlotVisitor& slotVisitor)
+{
+    Marker marker;
+    marker.IsMarked = isMarked;
+    marker.Mark = mark;
+    marker.visitor = &slotVisitor;
+    return marker;
+}
+
 } // anonymous namespace
 
 void JSContextGroupAddMarkingConstraint(JSContextGroupRef group, JSMarkingConstraint constraintCallback, void *userData)
@@ -75,11 +87,7 @@ void JSContextGroupAddMarkingConstraint(JSContextGroupRef group, JSMarkingConstr
         toCString("API Marking Constraint #", constraintIndex, " (", RawPointer(bitwise_cast<void*>(constraintCallback)), ", ", RawPointer(userData), ")"),
         [constraintCallback, userData]
         (SlotVisitor& slotVisitor) {
-            Marker marker;
-            marker.IsMarked = isMarked;
-            marker.Mark = mark;
-            marker.visitor = &slotVisitor;
-            
+            Marker marker = makeMarker(slotVisitor);
             constraintCallback(&marker, userData);
         },
         volatility,
@@ -87,3 +95,56 @@ void JSContextGroupAddMarkingConstraint(JSContextGroupRef group, JSMarkingConstr
     
     vm.heap.addMarkingConstraint(WTFMove(constraint));
 }
+
+void JSContextGroupAddParallelMarkingConstraint(JSContextGroupRef group, JSParallelMarkingConstraintPrepare prepareCallback, JSParallelMarkingConstraintShard shardCallback, void *userData)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(vm);
+    
+    unsigned constraintIndex = constraintCounter.exchangeAdd(1);
+    
+    // Unlike JSContextGroupAddMarkingConstraint, the client tells us its callbacks are thread-safe,
+    // so this constraint may run on any marking thread alongside other constraints.
+    auto constraint = makeUnique<SimpleMarkingConstraint>(
+        toCString("Apmc", constraintIndex, "(", RawPointer(bitwise_cast<void*>(shardCallback)), ")"),
+        toCString("API Parallel Marking Constraint #", constraintIndex, " (", RawPointer(bitwise_cast<void*>(shardCallback)), ", ", RawPointer(userData), ")"),
+        [prepareCallback, shardCallback, userData]
+        (SlotVisitor& slotVisitor) {
+            size_t numberOfShards = prepareCallback(userData);
+            if (!numberOfShards)
+                return;
+            
+            slotVisitor.addParallelConstraintTask(createSharedTask<void(SlotVisitor&)>(
+                [shardCallback, userData, numberOfShards, nextShard = Box<Atomic<size_t>>::create(0)]
+                (SlotVisitor& slotVisitor) {
+                    Marker marker = makeMarker(slotVisitor);
+                    for (;;) {
+                        size_t shardIndex = nextShard->exchangeAdd(1);
+                        if (shardIndex >= numberOfShards)
+                            return;
+                        shardCallback(&marker, shardIndex, userData);
+                    }
+                }));
+        },
+        ConstraintVolatility::GreyedByMarking,
+        ConstraintConcurrency::Concurrent,
+        ConstraintParallelism::Parallel);
+    
+    vm.heap.addMarkingConstraint(WTFMove(constraint));
+}
+
+void JSContextGroupGetMarkingConstraintTimings(JSContextGroupRef group, JSMarkingConstraintTimingCallback callback, void *userData)
+{
+    VM& vm = *toJS(group);
+    JSLockHolder locker(vm);
+    PreventCollectionScope preventCollectionScope(vm.heap);
+    
+    vm.heap.constraintSet().forEach(
+        [&] (MarkingConstraint& constraint) {
+            callback(
+                constraint.name(),
+                constraint.executionTimeInLastCollection().milliseconds(),
+                constraint.totalExecutionTime().milliseconds(),
+                userData);
+        });
+}
@@ -28,6 +28,7 @@
 
 #include <JavaScriptCore/JSContextRef.h>
 #include <stdbool.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,27 @@ typedef void (*JSMarkingConstraint)(JSMarkerRef, void *userData);
 
 JS_EXPORT void JSContextGroupAddMarkingConstraint(JSContextGroupRef, JSMarkingConstraint, void *userData);
 
+/*
+ A parallel marking constraint splits its work into shards that the collector's marking threads
+ run concurrently. Each time the constraint runs, the prepare callback is called once and returns
+ the number of shards; the shard callback is then called exactly once for every shard index below
+ that number, possibly from several threads at once. IsMarked and Mark may be called from any of
+ these threads on the marker they were given.
+*/
+typedef size_t (*JSParallelMarkingConstraintPrepare)(void *userData);
+typedef void (*JSParallelMarkingConstraintShard)(JSMarkerRef, size_t shardIndex, void *userData);
+
+JS_EXPORT void JSContextGroupAddParallelMarkingConstraint(JSContextGroupRef, JSParallelMarkingConstraintPrepare, JSParallelMarkingConstraintShard, void *userData);
+
+/*
+ Calls the callback once for every marking constraint of the group, including the built-in ones,
+ with the time spent running it during the current or last collection and in total, in
+ milliseconds. Time spent in parallel work is summed across threads.
+*/
+typedef void (*JSMarkingConstraintTimingCallback)(const char *name, double lastCollectionMilliseconds, double totalMilliseconds, void *userData);
+
+JS_EXPORT void JSContextGroupGetMarkingConstraintTimings(JSContextGroupRef, JSMarkingConstraintTimingCallback, void *userData);
+
 #ifdef __cplusplus
 }
 #endif
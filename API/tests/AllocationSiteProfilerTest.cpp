@@ -0,0 +1,174 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "AllocationSiteProfilerTest.h"
+
+#include "APICast.h"
+#include "AllocationSiteProfiler.h"
+#include "InitializeThreading.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+// Allocates a tree of small objects, keeping one in eight alive, so that the collector has both
+// survivors and garbage to deal with.
+static const char* workloadScript =
+    "function allocationWorkload() {"
+    "    var kept = [];"
+    "    for (var i = 0; i < 200000; ++i) {"
+    "        var object = { i: i, next: null, name: 'object' + (i & 63) };"
+    "        if (!(i & 7))"
+    "            kept.push(object);"
+    "    }"
+    "    return kept.length;"
+    "}";
+
+static constexpr double maximumOverheadPercent = 10;
+
+static Seconds timeWorkload(JSGlobalContextRef context)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString("allocationWorkload();");
+    // Warm up, so that we compare steady state JIT code rather than compile times.
+    for (unsigned i = 0; i < 5; ++i)
+        JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    Seconds best = Seconds::infinity();
+    for (unsigned i = 0; i < 10; ++i) {
+        MonotonicTime before = MonotonicTime::now();
+        JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+        best = std::min(best, MonotonicTime::now() - before);
+    }
+    JSStringRelease(script);
+    return best;
+}
+
+static JSGlobalContextRef createContext(const char* options)
+{
+    Options::setOptions(options);
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSStringRef script = JSStringCreateWithUTF8CString(workloadScript);
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+    return context;
+}
+
+static void collectGarbage(JSGlobalContextRef context)
+{
+    JSC::VM& vm = toJS(context)->vm();
+    JSC::JSLockHolder locker(vm);
+    vm.heap.collectNow(JSC::Sync, JSC::CollectionScope::Full);
+}
+
+int testAllocationSiteProfiler()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    // Measure the overhead at an interval we would use in production. Only the allocation slow
+    // paths ever look at the profiler, so this should stay under the 3% we aim for. The bound we
+    // check is looser than that, since the two runs are timed in a shared test process.
+    {
+        JSGlobalContextRef context = createContext("--allocationSamplingInterval=0");
+        Seconds withoutSampling = timeWorkload(context);
+        JSGlobalContextRelease(context);
+
+        context = createContext("--allocationSamplingInterval=524288");
+        Seconds withSampling = timeWorkload(context);
+        JSGlobalContextRelease(context);
+
+        double overhead = (withSampling / withoutSampling - 1) * 100;
+        printf("Allocation site sampling overhead: %.2f%% (%.3f ms without, %.3f ms with sampling)\n",
+            overhead, withoutSampling.milliseconds(), withSampling.milliseconds());
+        if (overhead > maximumOverheadPercent) {
+            printf("FAIL: Allocation site sampling costs more than %.0f%%.\n", maximumOverheadPercent);
+            failed = true;
+        }
+    }
+
+    {
+        JSGlobalContextRef context = createContext("--allocationSamplingInterval=1024");
+        JSC::AllocationSiteProfiler* profiler = toJS(context)->vm().heap.allocationSiteProfiler();
+        if (!profiler) {
+            printf("FAIL: The allocation site profiler was not created.\n");
+            failed = true;
+        } else {
+            JSStringRef script = JSStringCreateWithUTF8CString(
+                "function retainingAllocationSite() { var result = []; for (var i = 0; i < 10000; ++i) result.push({ i: i }); return result; }"
+                "function garbageAllocationSite() { for (var i = 0; i < 10000; ++i) ({ i: i }); }"
+                "var retained = retainingAllocationSite();"
+                "garbageAllocationSite();");
+            JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+            JSStringRelease(script);
+            collectGarbage(context);
+            collectGarbage(context);
+
+            Optional<JSC::AllocationSiteProfiler::Site> retainingSite;
+            Optional<JSC::AllocationSiteProfiler::Site> garbageSite;
+            for (auto& site : profiler->topSites(std::numeric_limits<unsigned>::max())) {
+                if (site.stack.startsWith("retainingAllocationSite"))
+                    retainingSite = site;
+                else if (site.stack.startsWith("garbageAllocationSite"))
+                    garbageSite = site;
+            }
+
+            if (!retainingSite || !retainingSite->numberOfLiveSamples || !retainingSite->retainedBytes) {
+                printf("FAIL: The allocation site profiler did not find the retaining site.\n");
+                failed = true;
+            } else if (retainingSite->maxSurvivedCollections < 2) {
+                printf("FAIL: Samples from the retaining site survived %u collections, expected at least 2.\n", retainingSite->maxSurvivedCollections);
+                failed = true;
+            } else
+                printf("PASS: The allocation site profiler found the retaining site.\n");
+
+            // Nothing from the garbage site is referenced once it returns, and its frames are gone
+            // from the stack by the time we collect, so none of its samples may survive.
+            if (!garbageSite || !garbageSite->numberOfSamples) {
+                printf("FAIL: The allocation site profiler did not find the garbage site.\n");
+                failed = true;
+            } else if (garbageSite->numberOfLiveSamples || garbageSite->maxSurvivedCollections) {
+                printf("FAIL: Samples from the garbage site survived %u collections.\n", garbageSite->maxSurvivedCollections);
+                failed = true;
+            } else
+                printf("PASS: The allocation site profiler dropped dead samples.\n");
+
+            if (profiler->toJSON(10).find("\"maxSurvivedCollections\":") == notFound) {
+                printf("FAIL: The allocation site profiler JSON does not report maxSurvivedCollections.\n");
+                failed = true;
+            }
+        }
+        JSGlobalContextRelease(context);
+    }
+
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    return failed;
+}
@@ -0,0 +1,118 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "ArrayCardMarkingTest.h"
+
+#include "APICast.h"
+#include "InitializeThreading.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+static constexpr unsigned arrayLength = 8192;
+static constexpr unsigned numberOfRounds = 8;
+
+static JSValueRef evaluate(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception) {
+        printf("FAIL: Unexpected exception while evaluating %s\n", source);
+        return nullptr;
+    }
+    return result;
+}
+
+static void collect(JSGlobalContextRef context, JSC::CollectionScope scope)
+{
+    JSC::VM& vm = toJS(context)->vm();
+    JSC::JSLockHolder locker(vm);
+    vm.heap.collectNow(JSC::Sync, scope);
+}
+
+int testArrayCardMarking()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    Options::setOptions("--useArrayCardMarking=true --minimumArrayLengthForCardMarking=1024");
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+
+    JSObjectRef bigArray = JSValueToObject(context, evaluate(context,
+        "var bigArray = [];"
+        "for (var i = 0; i < 8192; ++i)"
+        "    bigArray.push({ round: -1, index: i });"
+        "function makeElement(round, index) { return { round: round, index: index, payload: [round, index] }; }"
+        "function makeGarbage() { for (var i = 0; i < 100000; ++i) ({ round: -2, index: -2, payload: [i] }); }"
+        "bigArray;"), nullptr);
+    JSObjectRef makeElement = JSValueToObject(context, evaluate(context, "makeElement"), nullptr);
+
+    // Make the array old and black, so that element stores into it dirty cards.
+    collect(context, JSC::CollectionScope::Full);
+
+    // Store young objects into a few elements of every card each round. The only thing keeping
+    // them alive across the Eden collections is the dirty card they were stored into.
+    for (unsigned round = 0; round < numberOfRounds; ++round) {
+        for (unsigned index = round; index < arrayLength; index += 37) {
+            JSValueRef arguments[] = { JSValueMakeNumber(context, round), JSValueMakeNumber(context, index) };
+            JSValueRef element = JSObjectCallAsFunction(context, makeElement, nullptr, 2, arguments, nullptr);
+            JSObjectSetPropertyAtIndex(context, bigArray, index, element, nullptr);
+        }
+        collect(context, JSC::CollectionScope::Eden);
+        evaluate(context, "makeGarbage();");
+        collect(context, JSC::CollectionScope::Eden);
+    }
+
+    JSValueRef survived = evaluate(context,
+        "(function() {"
+        "    for (var i = 0; i < bigArray.length; ++i) {"
+        "        var element = bigArray[i];"
+        "        if (element.index !== i)"
+        "            return false;"
+        "        if (element.round >= 0 && (element.payload[0] !== element.round || element.payload[1] !== i))"
+        "            return false;"
+        "    }"
+        "    return true;"
+        "})()");
+    if (!survived || !JSValueToBoolean(context, survived)) {
+        printf("FAIL: Young objects stored into a large old array did not survive Eden collections.\n");
+        failed = true;
+    } else
+        printf("PASS: Young objects stored into a large old array survived Eden collections.\n");
+
+    JSGlobalContextRelease(context);
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    return failed;
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "BaselineCompilerThreadsTest.h"
+
+#include "APICast.h"
+#include "CodeBlock.h"
+#include "InitializeThreading.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+static constexpr unsigned numberOfFunctions = 40;
+static constexpr unsigned maximumNumberOfRounds = 1000;
+
+// Forty distinct functions that all get warm at the same time, called through one polymorphic call
+// site. Each has far more bytecode than the main thread compile limit below, so every one of them
+// has to be compiled by the baseline compiler threads.
+static const char* setupScript =
+    "var functions = [];"
+    "for (var k = 0; k < 40; ++k)"
+    "    functions.push(new Function('x', 'var s = ' + k + '; for (var i = 0; i < 10; ++i) { s += x * i; s ^= i; } return s;'));"
+    "function runRound() {"
+    "    for (var i = 0; i < 10; ++i) {"
+    "        for (var j = 0; j < functions.length; ++j)"
+    "            functions[j](i);"
+    "    }"
+    "}";
+
+static JSValueRef evaluate(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception) {
+        printf("FAIL: Unexpected exception while evaluating %s\n", source);
+        return nullptr;
+    }
+    return result;
+}
+
+static unsigned numberOfBaselineCompiledFunctions(JSGlobalContextRef context, JSObjectRef functions)
+{
+    JSC::JSGlobalObject* globalObject = toJS(context);
+    JSC::JSLockHolder locker(globalObject->vm());
+    unsigned result = 0;
+    for (unsigned i = 0; i < numberOfFunctions; ++i) {
+        JSC::JSValue function = toJS(globalObject, JSObjectGetPropertyAtIndex(context, functions, i, nullptr));
+        JSC::CodeBlock* codeBlock = JSC::jsCast<JSC::JSFunction*>(function)->jsExecutable()->codeBlockForCall();
+        if (codeBlock && codeBlock->jitType() != JSC::JITType::InterpreterThunk)
+            ++result;
+    }
+    return result;
+}
+
+int testBaselineCompilerThreads()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    if (!Options::useJIT() || !Options::useBaselineJIT()) {
+        printf("PASS: Skipping the baseline compiler threads test since the baseline JIT is disabled.\n");
+        return failed;
+    }
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    // With the main thread limit this low, a CodeBlock that finds every compiler thread busy waits in
+    // the queue instead of being compiled on the main thread, so the functions only reach the baseline
+    // JIT if the compiler threads keep taking queued plans and poll() installs them.
+    Options::setOptions("--numberOfBaselineCompilerThreads=4 --maximumInstructionsSizeForMainThreadBaselineCompile=16"
+        " --useConcurrentJIT=true --useDFGJIT=false"
+        " --thresholdForJITAfterWarmUp=10 --thresholdForJITSoon=10");
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    evaluate(context, setupScript);
+    JSObjectRef functions = JSValueToObject(context, evaluate(context, "functions"), nullptr);
+
+    unsigned compiled = 0;
+    for (unsigned round = 0; round < maximumNumberOfRounds && compiled < numberOfFunctions; ++round) {
+        evaluate(context, "runRound();");
+        compiled = numberOfBaselineCompiledFunctions(context, functions);
+    }
+
+    if (compiled < numberOfFunctions) {
+        printf("FAIL: Only %u of %u functions were baseline compiled by several compiler threads.\n", compiled, numberOfFunctions);
+        failed = true;
+    } else
+        printf("PASS: Every function was baseline compiled by several compiler threads with a low main thread compile limit.\n");
+
+    JSGlobalContextRelease(context);
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    return failed;
+}
@@ -0,0 +1,140 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "CodeBlockLifecycleLogTest.h"
+
+#include "InitializeThreading.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include "ProfilerLifecycleLog.h"
+#include <wtf/FileSystem.h>
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+// Warms the function up until the DFG compiles it for integers, then feeds it strings until it
+// has exited enough times to be jettisoned.
+static const char* tierUpAndExitScript(const char* name)
+{
+    static char script[1024];
+    snprintf(script, sizeof(script),
+        "function %s(a, b) { return a + b; }"
+        "(function() {"
+        "    for (var i = 0; i < 10000; ++i)"
+        "        %s(i, 1);"
+        "    for (var i = 0; i < 1000; ++i)"
+        "        %s('a' + i, 'b');"
+        "})();", name, name, name);
+    return script;
+}
+
+static void evaluate(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception)
+        printf("FAIL: Unexpected exception while evaluating %s\n", source);
+}
+
+static unsigned numberOfEvents(const String& json)
+{
+    unsigned count = 0;
+    for (size_t index = json.find("\"event\":"); index != notFound; index = json.find("\"event\":", index + 1))
+        ++count;
+    return count;
+}
+
+int testCodeBlockLifecycleLog()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    if (!Options::useJIT() || !Options::useDFGJIT()) {
+        printf("PASS: Skipping the CodeBlock lifecycle log test since the DFG is disabled.\n");
+        return failed;
+    }
+
+    FileSystem::PlatformFileHandle handle;
+    String path = FileSystem::openTemporaryFile("CodeBlockLifecycleLog", handle);
+    FileSystem::closeFile(handle);
+    CString filename = path.utf8();
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    // The log opens its file the first time it is used, so everything below shares one file.
+    StringBuilder optionsBuilder;
+    optionsBuilder.append("--codeBlockLifecycleLogFile=", filename.data(),
+        " --codeBlockLifecycleLogSampleRate=1 --useConcurrentJIT=false --useFTLJIT=false"
+        " --thresholdForJITAfterWarmUp=10 --thresholdForJITSoon=10"
+        " --thresholdForOptimizeAfterWarmUp=100 --thresholdForOptimizeSoon=100"
+        " --osrExitCountForReoptimization=10");
+    Options::setOptions(optionsBuilder.toString().ascii().data());
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+
+    evaluate(context, tierUpAndExitScript("sampledLifecycleTest"));
+    JSC::Profiler::LifecycleLog::singleton().flush();
+    String json = JSC::Profiler::LifecycleLog::readAsJSON(filename.data());
+    if (json.isNull()) {
+        printf("FAIL: The CodeBlock lifecycle log could not be decoded.\n");
+        failed = true;
+    } else {
+        auto expect = [&] (const char* fragment, const char* description) {
+            if (json.find(fragment) == notFound) {
+                printf("FAIL: The CodeBlock lifecycle log has no %s.\n", description);
+                failed = true;
+            }
+        };
+        expect("\"event\":\"compile\",\"tier\":\"DFG\"", "DFG compile");
+        expect("\"event\":\"installCode\",\"tier\":\"DFG\"", "DFG code install");
+        expect("\"event\":\"osrExit\",\"tier\":\"DFG\"", "OSR exit from DFG code");
+        expect("\"event\":\"jettison\",\"tier\":\"DFG\"", "jettison of DFG code");
+        expect("\"reason\":\"OSRExit\"", "jettison due to OSR exits");
+        if (!failed)
+            printf("PASS: The CodeBlock lifecycle log recorded a DFG compile, an OSR exit and a jettison.\n");
+
+        // The sample rate is read for every event, so turning it down drops everything from now on.
+        unsigned eventsBefore = numberOfEvents(json);
+        Options::setOptions("--codeBlockLifecycleLogSampleRate=0");
+        evaluate(context, tierUpAndExitScript("unsampledLifecycleTest"));
+        JSC::Profiler::LifecycleLog::singleton().flush();
+        unsigned eventsAfter = numberOfEvents(JSC::Profiler::LifecycleLog::readAsJSON(filename.data()));
+        if (eventsAfter != eventsBefore) {
+            printf("FAIL: The CodeBlock lifecycle log recorded %u events with a sample rate of 0.\n", eventsAfter - eventsBefore);
+            failed = true;
+        } else
+            printf("PASS: The CodeBlock lifecycle log recorded nothing with a sample rate of 0.\n");
+    }
+
+    JSGlobalContextRelease(context);
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    FileSystem::deleteFile(path);
+    return failed;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "ConcurrentDestructionTest.h"
+
+#include "APICast.h"
+#include "InitializeThreading.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+static constexpr unsigned numberOfRounds = 10;
+
+// Each round drops thousands of Intl.Segmenter segment collections and iterators, whose destructors
+// may run on heap helper threads, and keeps a few of them alive to check that the helpers leave
+// live cells alone.
+static const char* churnScript =
+    "var keptSegments = [];"
+    "var text = 'The quick brown fox jumps over the lazy dog';"
+    "function churnSegments() {"
+    "    var count = 0;"
+    "    for (var i = 0; i < 2000; ++i) {"
+    "        var segments = new Intl.Segmenter('en', { granularity: 'word' }).segment(text);"
+    "        for (var segment of segments)"
+    "            ++count;"
+    "        if (!(i % 100))"
+    "            keptSegments.push(segments);"
+    "    }"
+    "    return count;"
+    "}"
+    "function keptSegmentsAreIntact() {"
+    "    for (var segments of keptSegments) {"
+    "        var words = [];"
+    "        for (var segment of segments) {"
+    "            if (segment.isWordLike)"
+    "                words.push(segment.segment);"
+    "        }"
+    "        if (words.join(' ') !== text)"
+    "            return false;"
+    "    }"
+    "    return true;"
+    "}";
+
+static JSValueRef evaluate(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception) {
+        printf("FAIL: Unexpected exception while evaluating %s\n", source);
+        return nullptr;
+    }
+    return result;
+}
+
+int testConcurrentDestruction()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    Options::setOptions("--useConcurrentDestruction=true");
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSC::VM& vm = toJS(context)->vm();
+
+    evaluate(context, churnScript);
+    for (unsigned round = 0; round < numberOfRounds; ++round) {
+        evaluate(context, "churnSegments();");
+        {
+            JSC::JSLockHolder locker(vm);
+            vm.heap.collectNow(JSC::Sync, round % 2 ? JSC::CollectionScope::Eden : JSC::CollectionScope::Full);
+            // Odd rounds leave the blocks for the allocator to claim from the helpers, even rounds
+            // sweep them without allocating, which claims them without a free list.
+            if (!(round % 2))
+                vm.heap.sweepSynchronously();
+        }
+    }
+
+    JSValueRef intact = evaluate(context, "keptSegmentsAreIntact();");
+    if (!intact || !JSValueToBoolean(context, intact)) {
+        printf("FAIL: Live Intl.Segmenter segments were damaged by concurrent destruction.\n");
+        failed = true;
+    } else
+        printf("PASS: Intl.Segmenter segments survive concurrent destruction of their dead neighbors.\n");
+
+    JSGlobalContextRelease(context);
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    return failed;
+}
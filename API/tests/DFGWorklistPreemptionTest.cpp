@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "DFGWorklistPreemptionTest.h"
+
+#include "APICast.h"
+#include "CodeBlock.h"
+#include "InitializeThreading.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+static constexpr unsigned numberOfFunctions = 40;
+static constexpr unsigned maximumNumberOfRounds = 1000;
+
+// Forty distinct functions that all get hot at the same time, called through one polymorphic call
+// site so that none of them is inlined into the driver and each has to be compiled on its own.
+static const char* setupScript =
+    "var functions = [];"
+    "for (var k = 0; k < 40; ++k)"
+    "    functions.push(new Function('x', 'var s = ' + k + '; for (var i = 0; i < 10; ++i) s += x * i; return s;'));"
+    "function runRound() {"
+    "    for (var i = 0; i < 100; ++i) {"
+    "        for (var j = 0; j < functions.length; ++j)"
+    "            functions[j](i);"
+    "    }"
+    "}";
+
+static JSValueRef evaluate(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception) {
+        printf("FAIL: Unexpected exception while evaluating %s\n", source);
+        return nullptr;
+    }
+    return result;
+}
+
+static unsigned numberOfOptimizedFunctions(JSGlobalContextRef context, JSObjectRef functions)
+{
+    JSC::JSGlobalObject* globalObject = toJS(context);
+    JSC::JSLockHolder locker(globalObject->vm());
+    unsigned result = 0;
+    for (unsigned i = 0; i < numberOfFunctions; ++i) {
+        JSC::JSValue function = toJS(globalObject, JSObjectGetPropertyAtIndex(context, functions, i, nullptr));
+        JSC::CodeBlock* codeBlock = JSC::jsCast<JSC::JSFunction*>(function)->jsExecutable()->codeBlockForCall();
+        if (codeBlock && JSC::JITCode::isOptimizingJIT(codeBlock->jitType()))
+            ++result;
+    }
+    return result;
+}
+
+int testDFGWorklistPreemption()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    if (!Options::useJIT() || !Options::useDFGJIT()) {
+        printf("PASS: Skipping the DFG worklist preemption test since the DFG is disabled.\n");
+        return failed;
+    }
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    // With one compiler thread and a queue delay this short, almost every plan that is still queued
+    // when the next one arrives gets cancelled, so functions only tier up if cancelled plans really
+    // are retried.
+    Options::setOptions("--useDFGWorklistPriorities=true --maximumDFGPlanQueueDelay=0.1 --numberOfDFGCompilerThreads=1"
+        " --useConcurrentJIT=true --useFTLJIT=false"
+        " --thresholdForJITAfterWarmUp=10 --thresholdForJITSoon=10"
+        " --thresholdForOptimizeAfterWarmUp=100 --thresholdForOptimizeSoon=100");
+
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    evaluate(context, setupScript);
+    JSObjectRef functions = JSValueToObject(context, evaluate(context, "functions"), nullptr);
+
+    unsigned optimized = 0;
+    for (unsigned round = 0; round < maximumNumberOfRounds && optimized < numberOfFunctions; ++round) {
+        evaluate(context, "runRound();");
+        optimized = numberOfOptimizedFunctions(context, functions);
+    }
+
+    if (optimized < numberOfFunctions) {
+        printf("FAIL: Only %u of %u functions tiered up to the DFG with stale plan preemption.\n", optimized, numberOfFunctions);
+        failed = true;
+    } else
+        printf("PASS: Every function tiered up to the DFG with stale plan preemption and prioritized plans.\n");
+
+    JSGlobalContextRelease(context);
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    return failed;
+}
@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "IdleCollectionTest.h"
+
+#include "InitializeThreading.h"
+#include "JSContextRefPrivate.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/MonotonicTime.h>
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+extern "C" void JSSynchronousGarbageCollectForDebugging(JSContextRef);
+
+int testIdleCollection()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    // A few hundred kilobytes of allocation is far too little to make a collection due by itself,
+    // but it is well past this fraction of any Eden budget a fresh heap can have.
+    Options::setOptions("--minimumEdenFullnessForIdleCollection=0.001");
+
+    JSContextGroupRef group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, nullptr);
+
+    JSSynchronousGarbageCollectForDebugging(context);
+
+    JSStringRef script = JSStringCreateWithUTF8CString("var garbage = []; for (var i = 0; i < 10000; ++i) garbage.push({ i }); garbage = null;");
+    JSEvaluateScript(context, script, nullptr, nullptr, 1, nullptr);
+    JSStringRelease(script);
+
+    JSGarbageCollectionRecord before;
+    JSGarbageCollectionRecord after;
+    if (JSContextGroupCopyGarbageCollectionRecords(group, &before, 1) != 1) {
+        printf("FAIL: No garbage collection record before idle work.\n");
+        failed = true;
+    } else {
+        // Give it far more time than it needs, so that the collection and the sweep that follows it
+        // both finish and the call returns early.
+        Seconds budget = Seconds(10);
+        MonotonicTime start = MonotonicTime::now();
+        JSContextGroupPerformIdleWork(group, budget.milliseconds());
+        Seconds elapsed = MonotonicTime::now() - start;
+
+        if (JSContextGroupCopyGarbageCollectionRecords(group, &after, 1) != 1 || after.collectionID <= before.collectionID) {
+            printf("FAIL: Idle work did not start a collection that was due.\n");
+            failed = true;
+        } else if (elapsed >= budget) {
+            printf("FAIL: Idle work used its whole budget even though its work was done.\n");
+            failed = true;
+        } else
+            printf("PASS: Idle work started a due collection and finished early.\n");
+    }
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    return failed;
+}
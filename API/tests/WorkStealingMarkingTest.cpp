@@ -0,0 +1,123 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "WorkStealingMarkingTest.h"
+
+#include "APICast.h"
+#include "InitializeThreading.h"
+#include "JSCInlines.h"
+#include "JavaScript.h"
+#include "Options.h"
+#include <wtf/text/StringBuilder.h>
+
+using JSC::Options;
+
+static constexpr unsigned numberOfCollections = 10;
+
+// Builds enough live objects, in both deep trees and wide arrays, that every marker fills and
+// publishes several mark stack segments, then replaces part of them between collections.
+static const char* graphScript =
+    "function makeTree(depth) {"
+    "    if (!depth)"
+    "        return { value: 1 };"
+    "    return { left: makeTree(depth - 1), right: makeTree(depth - 1), value: depth };"
+    "}"
+    "function sumTree(tree) {"
+    "    return tree.left ? tree.value + sumTree(tree.left) + sumTree(tree.right) : tree.value;"
+    "}"
+    "var trees = [];"
+    "for (var i = 0; i < 8; ++i)"
+    "    trees.push(makeTree(14));"
+    "var wide = [];"
+    "for (var i = 0; i < 100000; ++i)"
+    "    wide.push({ index: i, payload: [i] });"
+    "var expectedSum = sumTree(trees[0]) * trees.length;"
+    "function churn(round) {"
+    "    trees[round % trees.length] = makeTree(14);"
+    "    for (var i = round; i < wide.length; i += 7)"
+    "        wide[i] = { index: i, payload: [i] };"
+    "}"
+    "function graphIsIntact() {"
+    "    var sum = 0;"
+    "    for (var tree of trees)"
+    "        sum += sumTree(tree);"
+    "    if (sum !== expectedSum)"
+    "        return false;"
+    "    for (var i = 0; i < wide.length; ++i) {"
+    "        if (wide[i].index !== i || wide[i].payload[0] !== i)"
+    "            return false;"
+    "    }"
+    "    return true;"
+    "}";
+
+static JSValueRef evaluate(JSGlobalContextRef context, const char* source)
+{
+    JSStringRef script = JSStringCreateWithUTF8CString(source);
+    JSValueRef exception = nullptr;
+    JSValueRef result = JSEvaluateScript(context, script, nullptr, nullptr, 1, &exception);
+    JSStringRelease(script);
+    if (exception) {
+        printf("FAIL: Unexpected exception while evaluating %s\n", source);
+        return nullptr;
+    }
+    return result;
+}
+
+int testWorkStealingMarking()
+{
+    bool failed = false;
+
+    JSC::initialize();
+
+    StringBuilder savedOptionsBuilder;
+    Options::dumpAllOptionsInALine(savedOptionsBuilder);
+
+    // verifyHeap checks after every collection that everything marked before is still a valid
+    // cell, and crashes if it is not.
+    Options::setOptions("--useWorkStealingMarking=true --numberOfGCMarkers=4 --verifyHeap=true");
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(nullptr, nullptr);
+    JSC::VM& vm = toJS(context)->vm();
+
+    evaluate(context, graphScript);
+    for (unsigned round = 0; round < numberOfCollections; ++round) {
+        StringBuilder churn;
+        churn.append("churn(", round, ");");
+        evaluate(context, churn.toString().ascii().data());
+        JSC::JSLockHolder locker(vm);
+        vm.heap.collectNow(JSC::Sync, JSC::CollectionScope::Full);
+    }
+
+    JSValueRef intact = evaluate(context, "graphIsIntact();");
+    if (!intact || !JSValueToBoolean(context, intact)) {
+        printf("FAIL: Objects were lost by full collections with work-stealing marking.\n");
+        failed = true;
+    } else
+        printf("PASS: Full collections with work-stealing marking keep every live object.\n");
+
+    JSGlobalContextRelease(context);
+    Options::setOptions(savedOptionsBuilder.toString().ascii().data());
+    return failed;
+}
@@ -33,6 +33,7 @@
 #endif
 
 #include "JSBasePrivate.h"
+#include "JSContextRefPrivate.h"
 #include "JSHeapFinalizerPrivate.h"
 #include "JSMarkingConstraintPrivate.h"
 #include "JSObjectRefPrivate.h"
@@ -57,16 +58,24 @@
 #include <windows.h>
 #endif
 
+#include "AllocationSiteProfilerTest.h"
+#include "ArrayCardMarkingTest.h"
+#include "BaselineCompilerThreadsTest.h"
+#include "CodeBlockLifecycleLogTest.h"
 #include "CompareAndSwapTest.h"
+#include "ConcurrentDestructionTest.h"
 #include "CustomGlobalObjectClassTest.h"
+#include "DFGWorklistPreemptionTest.h"
 #include "ExecutionTimeLimitTest.h"
 #include "FunctionOverridesTest.h"
 #include "GlobalContextWithFinalizerTest.h"
+#include "IdleCollectionTest.h"
 #include "JSONParseTest.h"
 #include "JSObjectGetProxyTargetTest.h"
 #include "MultithreadedMultiVMExecutionTest.h"
 #include "PingPongStackOverflowTest.h"
 #include "TypedArrayCTest.h"
+#include "WorkStealingMarkingTest.h"
 
 #if COMPILER(MSVC)
 #pragma warning(disable:4204)
@@ -1277,6 +1286,151 @@ static void testMarkingConstraintsAndHeapFinalizers(void)
     printf("PASS: Marking Constraints and Heap Finalizers.\n");
 }
 
+static const size_t parallelMarkingShardSize = 100;
+
+static size_t parallelMarkingConstraintPrepare(void *userData)
+{
+    UNUSED_PARAM(userData);
+    return numWeakRefs / parallelMarkingShardSize;
+}
+
+static void parallelMarkingConstraintShard(JSMarkerRef marker, size_t shardIndex, void *userData)
+{
+    JSWeakRef *weakRefs;
+    size_t i;
+    
+    weakRefs = (JSWeakRef*)userData;
+    
+    for (i = shardIndex * parallelMarkingShardSize; i < (shardIndex + 1) * parallelMarkingShardSize; i += 2) {
+        JSWeakRef weakRef = weakRefs[i];
+        if (weakRef)
+            marker->Mark(marker, JSWeakGetObject(weakRef));
+    }
+}
+
+static bool didSeeParallelMarkingConstraintTiming;
+
+static void markingConstraintTiming(const char *name, double lastCollectionMilliseconds, double totalMilliseconds, void *userData)
+{
+    UNUSED_PARAM(userData);
+    assertTrue(lastCollectionMilliseconds >= 0 && totalMilliseconds >= lastCollectionMilliseconds, "Marking constraint timings are consistent");
+    if (strstr(name, "API Parallel Marking Constraint"))
+        didSeeParallelMarkingConstraintTiming = true;
+}
+
+static void testParallelMarkingConstraints(void)
+{
+    JSContextGroupRef group;
+    JSWeakRef *weakRefs;
+    unsigned i;
+    unsigned deadCount;
+    
+    printf("Testing Parallel Marking Constraints.\n");
+    
+    group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, NULL);
+
+    weakRefs = (JSWeakRef*)calloc(numWeakRefs, sizeof(JSWeakRef));
+
+    JSContextGroupAddParallelMarkingConstraint(group, parallelMarkingConstraintPrepare, parallelMarkingConstraintShard, (void*)weakRefs);
+    
+    for (i = numWeakRefs; i--;)
+        weakRefs[i] = JSWeakCreate(group, JSObjectMakeArray(context, 0, NULL, NULL));
+    
+    JSSynchronousGarbageCollectForDebugging(context);
+    
+    deadCount = 0;
+    for (i = 0; i < numWeakRefs; i += 2) {
+        assertTrue((bool)JSWeakGetObject(weakRefs[i]), "Objects marked by a parallel constraint stayed alive");
+        if (!JSWeakGetObject(weakRefs[i + 1]))
+            deadCount++;
+    }
+    
+    assertTrue(deadCount != 0, "At least some objects died");
+
+    didSeeParallelMarkingConstraintTiming = false;
+    JSContextGroupGetMarkingConstraintTimings(group, markingConstraintTiming, NULL);
+    assertTrue(didSeeParallelMarkingConstraintTiming, "Parallel marking constraint has timings");
+    
+    for (i = numWeakRefs; i--;) {
+        JSWeakRef weakRef = weakRefs[i];
+        weakRefs[i] = NULL;
+        JSWeakRelease(group, weakRef);
+    }
+    JSSynchronousGarbageCollectForDebugging(context);
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("PASS: Parallel Marking Constraints.\n");
+}
+
+static void testGarbageCollectionRecords(void)
+{
+    JSContextGroupRef group;
+    JSGarbageCollectionRecord records[2];
+    size_t count;
+    JSStringRef json;
+
+    printf("Testing Garbage Collection Records.\n");
+
+    group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, NULL);
+
+    JSSynchronousGarbageCollectForDebugging(context);
+    JSSynchronousGarbageCollectForDebugging(context);
+    JSSynchronousGarbageCollectForDebugging(context);
+
+    count = JSContextGroupCopyGarbageCollectionRecords(group, records, 2);
+    assertTrue(count == 2, "Copied as many records as fit");
+    assertTrue(records[0].collectionID + 1 == records[1].collectionID, "Records are consecutive and oldest first");
+    assertTrue(records[1].isFullCollection, "Synchronous debugging collection is full");
+    assertTrue(records[1].duration >= records[1].totalPauseTime, "Pause is part of the collection");
+    assertTrue(records[1].totalPauseTime >= records[1].maxPauseTime, "Longest pause is part of the total");
+    assertTrue(records[1].bytesVisited > 0, "Visited something");
+
+    json = JSContextGroupCopyGarbageCollectionRecordsJSON(group);
+    assertTrue(JSStringGetLength(json) > 2, "JSON has records");
+    JSStringRelease(json);
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("PASS: Garbage Collection Records.\n");
+}
+
+static void testIdleWork(void)
+{
+    JSContextGroupRef group;
+    JSGarbageCollectionRecord before;
+    JSGarbageCollectionRecord after;
+
+    printf("Testing Idle Work.\n");
+
+    group = JSContextGroupCreate();
+    JSGlobalContextRef context = JSGlobalContextCreateInGroup(group, NULL);
+
+    JSStringRef script = JSStringCreateWithUTF8CString("var garbage = []; for (var i = 0; i < 100000; ++i) garbage.push({ i }); garbage = null;");
+    JSEvaluateScript(context, script, NULL, NULL, 1, NULL);
+    JSStringRelease(script);
+
+    JSSynchronousGarbageCollectForDebugging(context);
+    assertTrue(JSContextGroupCopyGarbageCollectionRecords(group, &before, 1) == 1, "Collected before idle work");
+    JSContextGroupPerformIdleWork(group, 0);
+    assertTrue(JSContextGroupCopyGarbageCollectionRecords(group, &after, 1) == 1, "Records survive idle work");
+    assertTrue(before.collectionID == after.collectionID, "No collection starts without idle time");
+
+    /* Nothing was allocated since the last collection, so none is due, however much time there is. */
+    JSContextGroupPerformIdleWork(group, 100);
+    assertTrue(JSContextGroupCopyGarbageCollectionRecords(group, &after, 1) == 1, "Records survive long idle work");
+    assertTrue(before.collectionID == after.collectionID, "No collection starts in idle time unless one is due");
+
+    JSGlobalContextRelease(context);
+    JSContextGroupRelease(group);
+
+    printf("PASS: Idle Work.\n");
+}
+
 #if USE(CF)
 static void testCFStrings(void)
 {
@@ -1401,6 +1555,14 @@ int main(int argc, char* argv[])
 #endif
 
     const char* filter = argc > 1 ? argv[1] : NULL;
+
+    /* These change how many compiler threads there are, which only takes effect when the first
+       compile creates the global worklists, so they have to run before anything else compiles. */
+    if (!filter) {
+        failed |= testBaselineCompilerThreads();
+        failed |= testDFGWorklistPreemption();
+    }
+
 #if JSC_OBJC_API_ENABLED
     testObjectiveCAPI(filter);
 #endif
@@ -1422,6 +1584,9 @@ int main(int argc, char* argv[])
     ASSERT(Base_didFinalize);
 
     testMarkingConstraintsAndHeapFinalizers();
+    testParallelMarkingConstraints();
+    testGarbageCollectionRecords();
+    testIdleWork();
 
 #if USE(CF)
     testCFStrings();
@@ -2165,6 +2330,12 @@ int main(int argc, char* argv[])
     // to do its work without changing JIT options, but that is not easy to do.
     // For now, we'll just run it here at the end as a workaround.
     failed |= testExecutionTimeLimit();
+    failed |= testAllocationSiteProfiler();
+    failed |= testCodeBlockLifecycleLog();
+    failed |= testArrayCardMarking();
+    failed |= testIdleCollection();
+    failed |= testConcurrentDestruction();
+    failed |= testWorkStealingMarking();
 
     if (failed) {
         printf("FAIL: Some tests failed.\n");
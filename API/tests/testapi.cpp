@@ -26,13 +26,20 @@
 #include "config.h"
 
 #include "APICast.h"
+#include "CodeBlock.h"
+#include "DeferGC.h"
+#include "HeapSnapshotBuilder.h"
+#include "JSCInlines.h"
 #include "JSGlobalObjectInlines.h"
 #include "MarkedJSValueRefArray.h"
+#include "ProfileCache.h"
 #include <JavaScriptCore/JSContextRefPrivate.h>
 #include <JavaScriptCore/JSObjectRefPrivate.h>
 #include <JavaScriptCore/JavaScript.h>
 #include <wtf/DataLog.h>
 #include <wtf/Expected.h>
+#include <wtf/FileSystem.h>
+#include <wtf/HashSet.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/NumberOfCores.h>
 #include <wtf/Vector.h>
@@ -151,6 +158,8 @@ public:
     void markedJSValueArrayAndGC();
     void classDefinitionWithJSSubclass();
     void proxyReturnedWithJSSubclassing();
+    void profileCacheRoundTrip();
+    void binaryHeapSnapshotRoundTrip();
 
     int failed() const { return m_failed; }
 
@@ -705,6 +714,213 @@ void TestAPI::proxyReturnedWithJSSubclassing()
     check(functionReturnsTrue("(function (subclass, Superclass) { return subclass.__proto__ == Superclass.prototype; })", subclass, Superclass), "proxy's prototype should match Superclass.prototype");
 }
 
+void TestAPI::profileCacheRoundTrip()
+{
+    FileSystem::PlatformFileHandle handle;
+    String path = FileSystem::openTemporaryFile("ProfileCache", handle);
+    FileSystem::closeFile(handle);
+    CString filename = path.utf8();
+
+    evaluateScript("function profileCacheTest(o) { return o.x + o.y; } for (let i = 0; i < 1000; ++i) profileCacheTest({ x: i, y: 1 });");
+
+    JSC::VM& vm = toJS(context)->vm();
+    JSC::JSLockHolder locker(vm);
+    {
+        JSC::ProfileCache cache(filename.data());
+        check(!cache.size(), "an empty profile cache file should load no entries");
+        cache.recordAndSave(vm);
+        check(cache.size(), "recording a VM that ran code should produce profile cache entries");
+
+        JSC::ProfileCache reloaded(filename.data());
+        check(reloaded.size() == cache.size(), "a saved profile cache should load back every entry");
+
+        auto baselineCodeBlock = [&] (JSGlobalContextRef context) {
+            JSC::JSGlobalObject* globalObject = toJS(context);
+            JSC::JSValue function = globalObject->get(globalObject, JSC::Identifier::fromString(vm, "profileCacheTest"));
+            return JSC::jsCast<JSC::JSFunction*>(function)->jsExecutable()->codeBlockForCall()->baselineVersion();
+        };
+        auto predictions = [&] (JSC::CodeBlock* codeBlock) {
+            Vector<JSC::SpeculatedType> result;
+            JSC::ConcurrentJSLocker codeBlockLocker(codeBlock->m_lock);
+            codeBlock->forEachValueProfile([&] (auto& profile, bool) {
+                result.append(profile.m_prediction);
+            });
+            return result;
+        };
+
+        // The same source in another global object gets a new CodeBlock with the same hash. It has run
+        // once in the LLInt, so it has not computed any predictions of its own yet.
+        JSC::CodeBlock* recorded = baselineCodeBlock(context);
+        JSGlobalContextRef otherContext = JSGlobalContextCreateInGroup(JSContextGetGroup(context), nullptr);
+        APIString otherScript("function profileCacheTest(o) { return o.x + o.y; } profileCacheTest({ x: 1, y: 1 });");
+        JSEvaluateScript(otherContext, otherScript, nullptr, nullptr, 1, nullptr);
+        JSC::CodeBlock* seeded = baselineCodeBlock(otherContext);
+        check(seeded != recorded && seeded->hash() == recorded->hash(), "the same function in another global object should get a new CodeBlock with the same hash");
+
+        int32_t thresholdBeforeSeeding = seeded->llintExecuteCounter().m_activeThreshold;
+        reloaded.seed(seeded);
+
+        Vector<JSC::SpeculatedType> recordedPredictions = predictions(recorded);
+        Vector<JSC::SpeculatedType> seededPredictions = predictions(seeded);
+        check(recordedPredictions.size() == seededPredictions.size(), "a seeded CodeBlock should have as many value profiles as the recorded one");
+        bool hasRecordedPredictions = false;
+        bool seededEveryPrediction = true;
+        for (unsigned i = 0; i < std::min(recordedPredictions.size(), seededPredictions.size()); ++i) {
+            hasRecordedPredictions |= recordedPredictions[i] != JSC::SpecNone;
+            seededEveryPrediction &= JSC::isSubtypeSpeculation(recordedPredictions[i], seededPredictions[i]);
+        }
+        check(hasRecordedPredictions, "a function that ran in a loop should have recorded predictions");
+        check(seededEveryPrediction, "a seeded CodeBlock should get every prediction that was saved");
+        if (recorded->jitType() != JSC::JITType::InterpreterThunk)
+            check(seeded->llintExecuteCounter().m_activeThreshold < thresholdBeforeSeeding, "a CodeBlock whose function reached the baseline JIT should have its JIT threshold lowered when seeded");
+
+        JSGlobalContextRelease(otherContext);
+    }
+
+    {
+        FileSystem::PlatformFileHandle file = FileSystem::openFile(path, FileSystem::FileOpenMode::Write);
+        const char garbage[] = "not a profile cache\n";
+        FileSystem::writeToFile(file, garbage, sizeof(garbage) - 1);
+        FileSystem::closeFile(file);
+
+        JSC::ProfileCache corrupted(filename.data());
+        check(!corrupted.size(), "a corrupted profile cache file should be ignored");
+    }
+
+    FileSystem::deleteFile(path);
+}
+
+void TestAPI::binaryHeapSnapshotRoundTrip()
+{
+    evaluateScript("function heapSnapshotTestFunction() { } globalThis.heapSnapshotTestObject = { heapSnapshotTestProperty: heapSnapshotTestFunction };");
+
+    JSC::VM& vm = toJS(context)->vm();
+    JSC::JSLockHolder locker(vm);
+    for (auto type : { JSC::HeapSnapshotBuilder::InspectorSnapshot, JSC::HeapSnapshotBuilder::GCDebuggingSnapshot }) {
+        bool isGCDebugging = type == JSC::HeapSnapshotBuilder::GCDebuggingSnapshot;
+        const char* typeName = isGCDebugging ? "GC debugging" : "inspector";
+
+        Vector<uint8_t> data;
+        {
+            JSC::DeferGCForAWhile deferGC(vm.heap);
+            JSC::HeapSnapshotBuilder builder(vm.ensureHeapProfiler(), type);
+            builder.buildSnapshot();
+            builder.write(JSC::HeapSnapshotFormat::Binary, [&] (const uint8_t* chunk, size_t length) {
+                data.append(chunk, length);
+            });
+        }
+
+        // Read the snapshot back, following the format description in HeapSnapshotBuilder.cpp.
+        size_t offset = 0;
+        bool ok = true;
+        auto readByte = [&] () -> uint8_t {
+            if (offset >= data.size()) {
+                ok = false;
+                return 0;
+            }
+            return data[offset++];
+        };
+        auto readNumber = [&] () -> uint64_t {
+            uint64_t result = 0;
+            for (unsigned shift = 0; ok && shift < 64; shift += 7) {
+                uint8_t byte = readByte();
+                result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    break;
+            }
+            return result;
+        };
+        auto defineString = [&] (Vector<String>& strings) {
+            uint64_t index = readNumber();
+            uint64_t length = readNumber();
+            if (!ok || index != strings.size() || length > data.size() - offset) {
+                ok = false;
+                return;
+            }
+            strings.append(String::fromUTF8(data.data() + offset, length));
+            offset += length;
+        };
+
+        const char magic[] = "JSCHEAP2";
+        for (unsigned i = 0; i < sizeof(magic) - 1; ++i)
+            ok &= readByte() == static_cast<uint8_t>(magic[i]);
+        check(ok, "a binary ", typeName, " snapshot should start with the magic");
+        check(readByte() == static_cast<uint8_t>(type), "a binary ", typeName, " snapshot should record its type");
+
+        Vector<String> classNames;
+        Vector<String> labels;
+        Vector<String> edgeNames;
+        HashSet<uint64_t, IntHash<uint64_t>, WTF::UnsignedWithZeroKeyHashTraits<uint64_t>> nodeIdentifiers;
+        nodeIdentifiers.add(0); // The implicit <root> node.
+        unsigned numberOfNodes = 0;
+        unsigned numberOfEdges = 0;
+        unsigned numberOfRoots = 0;
+        bool stringsDefinedBeforeUse = true;
+        bool edgesReferToNodes = true;
+        bool sawEnd = false;
+        uint64_t previousFrom = 0;
+        while (ok && !sawEnd) {
+            switch (readByte()) {
+            case 0: // End
+                sawEnd = true;
+                break;
+            case 1: // ClassName
+                defineString(classNames);
+                break;
+            case 2: // Label
+                defineString(labels);
+                break;
+            case 3: // EdgeName
+                defineString(edgeNames);
+                break;
+            case 4: // Node
+                nodeIdentifiers.add(readNumber());
+                readNumber(); // sizeInBytes
+                stringsDefinedBeforeUse &= readNumber() < classNames.size();
+                readNumber(); // flags
+                if (isGCDebugging) {
+                    stringsDefinedBeforeUse &= readNumber() < labels.size();
+                    readNumber(); // cellAddress
+                    readNumber(); // wrappedAddress
+                }
+                numberOfNodes++;
+                break;
+            case 5: { // Edge
+                previousFrom += readNumber();
+                uint64_t to = readNumber();
+                edgesReferToNodes &= nodeIdentifiers.contains(previousFrom) && nodeIdentifiers.contains(to);
+                auto edgeType = static_cast<JSC::EdgeType>(readNumber());
+                uint64_t edgeData = readNumber();
+                if (edgeType == JSC::EdgeType::Property || edgeType == JSC::EdgeType::Variable)
+                    stringsDefinedBeforeUse &= edgeData < edgeNames.size();
+                numberOfEdges++;
+                break;
+            }
+            case 6: // Root
+                edgesReferToNodes &= nodeIdentifiers.contains(readNumber());
+                stringsDefinedBeforeUse &= readNumber() < labels.size();
+                stringsDefinedBeforeUse &= readNumber() < labels.size();
+                numberOfRoots++;
+                break;
+            default:
+                ok = false;
+                break;
+            }
+        }
+
+        check(ok && sawEnd && offset == data.size(), "a binary ", typeName, " snapshot should be well formed and end with an End record");
+        check(numberOfNodes && numberOfEdges, "a binary ", typeName, " snapshot should have nodes and edges");
+        check(stringsDefinedBeforeUse, "a binary ", typeName, " snapshot should define every string before using it");
+        check(edgesReferToNodes, "a binary ", typeName, " snapshot should only refer to nodes it contains");
+        check(!labels.isEmpty() && labels[0].isEmpty(), "a binary ", typeName, " snapshot should use label 0 for the empty label");
+        check(classNames.contains("Function"_s), "a binary ", typeName, " snapshot should contain functions");
+        check(edgeNames.contains("heapSnapshotTestProperty"_s), "a binary ", typeName, " snapshot should contain property edges");
+        check(isGCDebugging == !!numberOfRoots, "only binary GC debugging snapshots should have root records");
+        if (isGCDebugging)
+            check(labels.contains("heapSnapshotTestFunction"_s), "a binary GC debugging snapshot should label functions with their names");
+    }
+}
+
 void configureJSCForTesting()
 {
     JSC::Config::configureForTesting();
@@ -747,6 +963,8 @@ int testCAPIViaCpp(const char* filter)
     RUN(markedJSValueArrayAndGC());
     RUN(classDefinitionWithJSSubclass());
     RUN(proxyReturnedWithJSSubclassing());
+    RUN(profileCacheRoundTrip());
+    RUN(binaryHeapSnapshotRoundTrip());
 
     if (tasks.isEmpty()) {
         dataLogLn("Filtered all tests: ERROR");
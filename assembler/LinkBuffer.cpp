@@ -451,7 +451,7 @@ void LinkBuffer::allocate(MacroAssembler& macroAssembler, JITCompilationEffort e
         initialSize = macroAssembler.m_assembler.codeSize();
     }
 
-    m_executableMemory = ExecutableAllocator::singleton().allocate(initialSize, effort);
+    m_executableMemory = ExecutableAllocator::singleton().allocate(initialSize, effort, m_placement);
     if (!m_executableMemory)
         return;
     m_code = MacroAssemblerCodePtr<LinkBufferPtrTag>(m_executableMemory->start().retaggedPtr<LinkBufferPtrTag>());
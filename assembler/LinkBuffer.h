@@ -83,12 +83,13 @@ class LinkBuffer {
 #endif
 
 public:
-    LinkBuffer(MacroAssembler& macroAssembler, void* ownerUID, JITCompilationEffort effort = JITCompilationMustSucceed)
+    LinkBuffer(MacroAssembler& macroAssembler, void* ownerUID, JITCompilationEffort effort = JITCompilationMustSucceed, JITCodePlacement placement = JITCodePlacement::Hot)
         : m_size(0)
         , m_didAllocate(false)
 #ifndef NDEBUG
         , m_completed(false)
 #endif
+        , m_placement(placement)
     {
         UNUSED_PARAM(ownerUID);
         linkCode(macroAssembler, effort);
@@ -373,6 +374,7 @@ private:
     bool m_isJumpIsland { false };
 #endif
     bool m_alreadyDisassembled { false };
+    JITCodePlacement m_placement { JITCodePlacement::Hot };
     MacroAssemblerCodePtr<LinkBufferPtrTag> m_code;
     Vector<RefPtr<SharedTask<void(LinkBuffer&)>>> m_linkTasks;
 };
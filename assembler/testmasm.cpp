@@ -30,6 +30,7 @@
 #include "FPRInfo.h"
 #include "GPRInfo.h"
 #include "InitializeThreading.h"
+#include "JSCConfig.h"
 #include "LinkBuffer.h"
 #include "ProbeContext.h"
 #include "StackAlignment.h"
@@ -2347,6 +2348,43 @@ void testAndOrDouble()
     }
 }
 
+void testColdCodePlacement()
+{
+    // run() sets aside part of the executable pool for cold code, unless the JIT ended up disabled.
+    double coldFraction = Options::jitColdCodeRegionFraction();
+    if (!coldFraction)
+        return;
+
+    auto generate = [] (CCallHelpers& jit) {
+        emitFunctionPrologue(jit);
+        jit.move(CCallHelpers::TrustedImm32(42), GPRInfo::returnValueGPR);
+        emitFunctionEpilogue(jit);
+        jit.ret();
+    };
+
+    CCallHelpers coldJIT;
+    generate(coldJIT);
+    LinkBuffer coldLinkBuffer(coldJIT, nullptr, JITCompilationMustSucceed, JITCodePlacement::Cold);
+    auto cold = FINALIZE_CODE(coldLinkBuffer, JSEntryPtrTag, "testmasm cold compilation");
+    auto hot = compile(generate);
+    CHECK_EQ(invoke<int>(cold), 42);
+    CHECK_EQ(invoke<int>(hot), 42);
+
+    uintptr_t coldAddress = bitwise_cast<uintptr_t>(cold.code().untaggedExecutableAddress());
+    uintptr_t hotAddress = bitwise_cast<uintptr_t>(hot.code().untaggedExecutableAddress());
+    uintptr_t start = bitwise_cast<uintptr_t>(untagCodePtr<ExecutableMemoryPtrTag>(g_jscConfig.startExecutableMemory));
+    uintptr_t end = bitwise_cast<uintptr_t>(untagCodePtr<ExecutableMemoryPtrTag>(g_jscConfig.endExecutableMemory));
+
+    // Cold code fills the pool from its end and hot code from its start.
+    CHECK_EQ(start <= hotAddress && hotAddress < coldAddress && coldAddress < end, true);
+#if !ENABLE(JUMP_ISLANDS)
+    // Without jump islands, the cold region is exactly the tail of the pool.
+    uintptr_t coldRegionStart = end - static_cast<uintptr_t>((end - start) * coldFraction);
+    CHECK_EQ(coldAddress >= coldRegionStart, true);
+    CHECK_EQ(hotAddress < coldRegionStart, true);
+#endif
+}
+
 void testByteSwap()
 {
 #if CPU(X86_64) || CPU(ARM64)
@@ -2586,6 +2624,10 @@ static void testBranchIfNotType()
 
 void run(const char* filter)
 {
+    // The executable pool is carved up when JSC is initialized, so the cold region has to be
+    // requested before that.
+    JSC::Options::initialize();
+    JSC::Options::setOptions("--jitColdCodeRegionFraction=0.25");
     JSC::initialize();
     unsigned numberOfTests = 0;
 
@@ -2710,6 +2752,8 @@ void run(const char* filter)
 
     RUN(testAndOrDouble());
 
+    RUN(testColdCodePlacement());
+
     if (tasks.isEmpty())
         usage();
 
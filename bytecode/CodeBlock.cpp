@@ -70,7 +70,9 @@
 #include "ModuleProgramCodeBlock.h"
 #include "ObjectAllocationProfileInlines.h"
 #include "PCToCodeOriginMap.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
+#include "ProfilerLifecycleLog.h"
 #include "ProgramCodeBlock.h"
 #include "ReduceWhitespace.h"
 #include "SlotVisitorInlines.h"
@@ -797,6 +799,10 @@ bool CodeBlock::finishCreation(VM& vm, ScriptExecutable* ownerExecutable, Unlink
     optimizeAfterWarmUp();
     jitAfterWarmUp();
 
+    // Seeding may lower the thresholds we just set, so it has to come after them.
+    if (ProfileCache* profileCache = vm.profileCache())
+        profileCache->seed(this);
+
     // If the concurrent thread will want the code block's hash, then compute it here
     // synchronously.
     if (Options::alwaysComputeHash())
@@ -2192,6 +2198,9 @@ void CodeBlock::jettison(Profiler::JettisonReason reason, ReoptimizationMode mod
 
     CodeBlock* codeBlock = this; // Placate GCC for use in CODEBLOCK_LOG_EVENT  (does not like this).
     CODEBLOCK_LOG_EVENT(codeBlock, "jettison", ("due to ", reason, ", counting = ", mode == CountReoptimization, ", detail = ", pointerDump(detail)));
+#if ENABLE(JIT)
+    Profiler::logLifecycleEvent(codeBlock, Profiler::LifecycleEventKind::Jettison, jitType(), BytecodeIndex(), reason, std::min<uint32_t>(osrExitCounter(), UINT16_MAX));
+#endif
 
     RELEASE_ASSERT(reason != Profiler::NotJettisoned);
     
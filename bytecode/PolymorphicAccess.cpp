@@ -714,7 +714,7 @@ AccessGenerationResult PolymorphicAccess::regenerate(const GCSafeConcurrentJSLoc
         callSiteIndexForExceptionHandling = state.callSiteIndexForExceptionHandling();
     }
 
-    LinkBuffer linkBuffer(jit, codeBlock, JITCompilationCanFail);
+    LinkBuffer linkBuffer(jit, codeBlock, JITCompilationCanFail, JITCodePlacement::Cold);
     if (linkBuffer.didFailToAllocate()) {
         if (PolymorphicAccessInternal::verbose)
             dataLog("Did fail to allocate.\n");
@@ -41,6 +41,7 @@
 #include "JSCJSValueInlines.h"
 #include "OperandsInlines.h"
 #include "ProbeContext.h"
+#include "ProfilerLifecycleLog.h"
 
 #include <wtf/Scope.h>
 
@@ -167,6 +168,12 @@ JSC_DEFINE_JIT_OPERATION(operationCompileOSRExit, void, (CallFrame* callFrame))
 
     ASSERT(!vm.callFrameForCatch || exit.m_kind == GenericUnwind);
     EXCEPTION_ASSERT_UNUSED(scope, !!scope.exception() || !exit.isExceptionHandler());
+
+    if (UNLIKELY(Profiler::LifecycleLog::isEnabled())) {
+        const CodeOrigin& origin = exit.m_codeOriginForExitProfile;
+        CodeBlock* profiledBlock = baselineCodeBlockForOriginAndBaselineCodeBlock(origin, codeBlock->baselineAlternative());
+        Profiler::logLifecycleEvent(profiledBlock, Profiler::LifecycleEventKind::OSRExit, JITType::DFGJIT, origin.bytecodeIndex(), exit.m_kind);
+    }
     
     // Compute the value recoveries.
     Operands<ValueRecovery> operands;
@@ -203,7 +210,7 @@ JSC_DEFINE_JIT_OPERATION(operationCompileOSRExit, void, (CallFrame* callFrame))
 
         OSRExit::compileExit(jit, vm, exit, operands, recovery);
 
-        LinkBuffer patchBuffer(jit, codeBlock);
+        LinkBuffer patchBuffer(jit, codeBlock, JITCompilationMustSucceed, JITCodePlacement::Cold);
         exit.m_code = FINALIZE_CODE_IF(
             shouldDumpDisassembly() || Options::verboseOSR() || Options::verboseDFGOSRExit(),
             patchBuffer, OSRExitPtrTag,
@@ -76,6 +76,7 @@
 #include "JSCJSValueInlines.h"
 #include "OperandsInlines.h"
 #include "ProfilerDatabase.h"
+#include "ProfilerLifecycleLog.h"
 #include "TrackedReferences.h"
 #include "VMInlines.h"
 
@@ -94,6 +95,8 @@ extern Seconds totalDFGCompileTime;
 extern Seconds totalFTLCompileTime;
 extern Seconds totalFTLDFGCompileTime;
 extern Seconds totalFTLB3CompileTime;
+extern Seconds totalDFGQueueDelay;
+extern Seconds totalFTLQueueDelay;
 
 }
 
@@ -159,6 +162,8 @@ bool Plan::computeCompileTimes() const
 {
     return reportCompileTimes()
         || Options::reportTotalCompileTimes()
+        || Options::reportDFGPlanTimes()
+        || Profiler::LifecycleLog::isEnabled()
         || (m_vm && m_vm->m_perBytecodeProfiler);
 }
 
@@ -177,7 +182,7 @@ void Plan::compileInThread(ThreadData* threadData)
     CString codeBlockName;
     if (UNLIKELY(computeCompileTimes()))
         before = MonotonicTime::now();
-    if (UNLIKELY(reportCompileTimes()))
+    if (UNLIKELY(reportCompileTimes() || Options::reportDFGPlanTimes()))
         codeBlockName = toCString(*m_codeBlock);
 
     CompilationScope compilationScope;
@@ -191,16 +196,22 @@ void Plan::compileInThread(ThreadData* threadData)
     RELEASE_ASSERT((path == CancelPath) == (m_stage == Cancelled));
 
     MonotonicTime after { };
+    Seconds queueDelay;
     if (UNLIKELY(computeCompileTimes())) {
         after = MonotonicTime::now();
+        if (m_timeEnqueued)
+            queueDelay = before - m_timeEnqueued;
     
         if (Options::reportTotalCompileTimes()) {
             if (isFTL()) {
                 totalFTLCompileTime += after - before;
                 totalFTLDFGCompileTime += m_timeBeforeFTL - before;
                 totalFTLB3CompileTime += after - m_timeBeforeFTL;
-            } else
+                totalFTLQueueDelay += queueDelay;
+            } else {
                 totalDFGCompileTime += after - before;
+                totalDFGQueueDelay += queueDelay;
+            }
         }
     }
     const char* pathName = nullptr;
@@ -226,6 +237,9 @@ void Plan::compileInThread(ThreadData* threadData)
             CODEBLOCK_LOG_EVENT(m_codeBlock, "ftlCompile", ("took ", (after - before).milliseconds(), " ms (DFG: ", (m_timeBeforeFTL - before).milliseconds(), ", B3: ", (after - m_timeBeforeFTL).milliseconds(), ") with ", pathName));
         else
             CODEBLOCK_LOG_EVENT(m_codeBlock, "dfgCompile", ("took ", (after - before).milliseconds(), " ms with ", pathName));
+
+        JITType resultType = path == FTLPath ? JITType::FTLJIT : path == DFGPath ? JITType::DFGJIT : JITType::None;
+        Profiler::logLifecycleEvent(m_codeBlock, Profiler::LifecycleEventKind::Compile, resultType, m_osrEntryBytecodeIndex, static_cast<uint32_t>((after - before).microseconds()), m_mode);
     }
     if (UNLIKELY(reportCompileTimes())) {
         dataLog("Optimized ", codeBlockName, " using ", m_mode, " with ", pathName, " into ", m_finalizer ? m_finalizer->codeSize() : 0, " bytes in ", (after - before).milliseconds(), " ms");
@@ -233,6 +247,11 @@ void Plan::compileInThread(ThreadData* threadData)
             dataLog(" (DFG: ", (m_timeBeforeFTL - before).milliseconds(), ", B3: ", (after - m_timeBeforeFTL).milliseconds(), ")");
         dataLog(".\n");
     }
+    if (UNLIKELY(Options::reportDFGPlanTimes())) {
+        dataLogLn("{\"codeBlock\":\"", codeBlockName, "\",\"mode\":\"", m_mode, "\",\"path\":\"", pathName,
+            "\",\"priority\":", m_priority, ",\"queueDelayMS\":", queueDelay.milliseconds(),
+            ",\"compileMS\":", (after - before).milliseconds(), ",\"codeSize\":", m_finalizer ? m_finalizer->codeSize() : 0, "}");
+    }
 }
 
 Plan::CompilationPath Plan::compileInThreadImpl()
@@ -581,6 +600,17 @@ void Plan::reallyAdd(CommonData* commonData)
     }
 }
 
+void Plan::willEnqueue()
+{
+    m_timeEnqueued = MonotonicTime::now();
+
+    // Estimate how much we stand to gain from this compile: the hotter the baseline code got and the
+    // less bytecode there is to compile, the sooner we want it. This only orders the worklist queue.
+    CodeBlock* baseline = m_codeBlock->baselineAlternative();
+    double executionCount = std::max(baseline->jitExecuteCounter().count(), 1.0);
+    m_priority = executionCount / std::max(m_codeBlock->instructionsSize(), 1u);
+}
+
 void Plan::notifyCompiling()
 {
     m_stage = Compiling;
@@ -115,6 +115,11 @@ public:
     DeferredCompilationCallback* callback() const { return m_callback.get(); }
     void setCallback(Ref<DeferredCompilationCallback>&& callback) { m_callback = WTFMove(callback); }
 
+    // Only called on the main thread, right before the plan goes onto a worklist queue.
+    void willEnqueue();
+    double priority() const { return m_priority; }
+    MonotonicTime timeEnqueued() const { return m_timeEnqueued; }
+
 private:
     bool computeCompileTimes() const;
     bool reportCompileTimes() const;
@@ -167,6 +172,8 @@ private:
     RefPtr<DeferredCompilationCallback> m_callback;
 
     MonotonicTime m_timeBeforeFTL;
+    MonotonicTime m_timeEnqueued;
+    double m_priority { 0 };
 };
 
 #endif // ENABLE(DFG_JIT)
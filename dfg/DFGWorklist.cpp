@@ -58,7 +58,7 @@ private:
         if (m_worklist.m_queue.isEmpty())
             return PollResult::Wait;
         
-        m_plan = m_worklist.m_queue.takeFirst();
+        m_plan = m_worklist.takeNextPlan(locker);
         if (!m_plan) {
             if (Options::verboseCompilationQueue()) {
                 m_worklist.dump(locker, WTF::dataFile());
@@ -234,17 +234,66 @@ bool Worklist::isActiveForVM(VM& vm) const
 
 void Worklist::enqueue(Ref<Plan>&& plan)
 {
+    plan->willEnqueue();
+
     LockHolder locker(*m_lock);
     if (Options::verboseCompilationQueue()) {
         dump(locker, WTF::dataFile());
-        dataLog(": Enqueueing plan to optimize ", plan->key(), "\n");
+        dataLog(": Enqueueing plan to optimize ", plan->key(), " with priority ", plan->priority(), "\n");
     }
+    if (Options::maximumDFGPlanQueueDelay())
+        removeStalePlans(locker, *plan->vm(), plan->timeEnqueued());
     ASSERT(m_plans.find(plan->key()) == m_plans.end());
     m_plans.add(plan->key(), plan.copyRef());
     m_queue.append(WTFMove(plan));
     m_planEnqueued->notifyOne(locker);
 }
 
+RefPtr<Plan> Worklist::takeNextPlan(const AbstractLocker&)
+{
+    if (!Options::useDFGWorklistPriorities())
+        return m_queue.takeFirst();
+
+    // The queue is short enough that a linear scan is cheaper than keeping it sorted. Null plans ask
+    // a thread to shut down, so they are only taken once there is no real work left.
+    auto best = m_queue.end();
+    for (auto iter = m_queue.begin(); iter != m_queue.end(); ++iter) {
+        if (!*iter)
+            continue;
+        if (best == m_queue.end() || (*iter)->priority() > (*best)->priority())
+            best = iter;
+    }
+    if (best == m_queue.end())
+        return m_queue.takeFirst();
+
+    RefPtr<Plan> plan = WTFMove(*best);
+    m_queue.remove(best);
+    return plan;
+}
+
+void Worklist::removeStalePlans(const AbstractLocker&, VM& vm, MonotonicTime now)
+{
+    // A DFG plan that has sat in the queue for a long time was made from profiling that has since
+    // moved on. Cancelling it lets operationOptimize() start over with fresh profiles the next time
+    // the baseline code's counter fires, instead of us spending compile time on a stale plan.
+    // Only DFGMode plans are preempted since they are the only ones that are simply retried when
+    // their key disappears from the worklist.
+    Seconds maximumDelay = Seconds::fromMilliseconds(Options::maximumDFGPlanQueueDelay());
+    Deque<RefPtr<Plan>> newQueue;
+    while (!m_queue.isEmpty()) {
+        RefPtr<Plan> plan = m_queue.takeFirst();
+        if (plan && plan->vm() == &vm && plan->mode() == DFGMode && plan->stage() == Plan::Preparing
+            && now - plan->timeEnqueued() > maximumDelay) {
+            dataLogLnIf(Options::verboseCompilationQueue(), *this, ": Preempting stale plan ", plan->key());
+            m_plans.remove(plan->key());
+            plan->cancel();
+            continue;
+        }
+        newQueue.append(WTFMove(plan));
+    }
+    m_queue.swap(newQueue);
+}
+
 Worklist::State Worklist::compilationState(CompilationKey key)
 {
     LockHolder locker(*m_lock);
@@ -93,6 +93,8 @@ private:
     static void threadFunction(void* argument);
     
     void removeAllReadyPlansForVM(VM&, Vector<RefPtr<Plan>, 8>&);
+    RefPtr<Plan> takeNextPlan(const AbstractLocker&);
+    void removeStalePlans(const AbstractLocker&, VM&, MonotonicTime now);
 
     void dump(const AbstractLocker&, PrintStream&) const;
     
@@ -28,12 +28,16 @@
 #include "Identifier.h"
 #include "InitializeThreading.h"
 #include "JSCInlines.h"
+#include "JSArray.h"
 #include "JSCJSValue.h"
 #include "JSGlobalObject.h"
 #include "JSLock.h"
 #include "JSObject.h"
+#include "JSWeakMap.h"
 #include "VM.h"
+#include <wtf/Condition.h>
 #include <wtf/MainThread.h>
+#include <wtf/Threading.h>
 #include <wtf/text/StringCommon.h>
 
 using namespace JSC;
@@ -67,6 +71,22 @@ NEVER_INLINE void benchmarkImpl(const char* name, unsigned iterationCount, const
     dataLog(name, ": ", (after - before).milliseconds(), " ms.\n");
 }
 
+JSValue buildBinaryTree(VM& vm, JSGlobalObject* globalObject, Structure* structure, const Identifier& left, const Identifier& right, unsigned depth)
+{
+    JSValue object = JSFinalObject::create(vm, structure);
+    if (!depth)
+        return object;
+    {
+        PutPropertySlot slot(object, false);
+        object.putInline(globalObject, left, buildBinaryTree(vm, globalObject, structure, left, right, depth - 1), slot);
+    }
+    {
+        PutPropertySlot slot(object, false);
+        object.putInline(globalObject, right, buildBinaryTree(vm, globalObject, structure, left, right, depth - 1), slot);
+    }
+    return object;
+}
+
 } // anonymous namespace
 
 int main(int argc, char** argv)
@@ -234,6 +254,129 @@ int main(int argc, char** argv)
                     }
                 }
             });
+
+        // Full collection of a large, wide heap: 16 trees of 2^16 - 1 objects each, about one million
+        // objects. This mostly measures parallel marking, so compare runs with
+        // JSC_useWorkStealingMarking=true and false.
+        JSArray* largeHeap = constructEmptyArray(globalObject, nullptr);
+        globalObject->putDirect(vm, Identifier::fromString(vm, "largeHeap"), largeHeap);
+        for (unsigned i = 0; i < 16; ++i)
+            largeHeap->putDirectIndex(globalObject, i, buildBinaryTree(vm, globalObject, objectStructure, identF, identG, 15));
+        benchmarkImpl(
+            "Full Collection Of Large Heap",
+            10,
+            [&] (unsigned iterationCount) {
+                for (unsigned i = iterationCount; i--;)
+                    vm.heap.collectNow(Sync, CollectionScope::Full);
+            });
+
+        // Full collection of a large heap whose objects point at each other at random, so that
+        // marking hops between blocks in no particular order. This mostly measures TLB misses, so
+        // compare runs with JSC_useHugePagesForMarkedBlocks=true and false.
+        globalObject->putDirect(vm, Identifier::fromString(vm, "largeHeap"), jsUndefined());
+        {
+            constexpr unsigned numberOfObjects = 1 << 20;
+            JSArray* objects = constructEmptyArray(globalObject, nullptr);
+            globalObject->putDirect(vm, Identifier::fromString(vm, "randomHeap"), objects);
+            for (unsigned i = 0; i < numberOfObjects; ++i)
+                objects->putDirectIndex(globalObject, i, JSFinalObject::create(vm, objectStructure));
+            uint32_t random = 1;
+            auto randomObject = [&] {
+                random = random * 1103515245 + 12345;
+                return objects->getIndexQuickly((random >> 8) % numberOfObjects);
+            };
+            for (unsigned i = 0; i < numberOfObjects; ++i) {
+                JSValue object = objects->getIndexQuickly(i);
+                {
+                    PutPropertySlot slot(object, false);
+                    object.putInline(globalObject, identF, randomObject(), slot);
+                }
+                {
+                    PutPropertySlot slot(object, false);
+                    object.putInline(globalObject, identG, randomObject(), slot);
+                }
+            }
+            // Only keep what is reachable from the first object, so that marking does not just
+            // walk the array.
+            globalObject->putDirect(vm, Identifier::fromString(vm, "randomHeap"), objects->getIndexQuickly(0));
+        }
+        benchmarkImpl(
+            "Full Collection Of Randomly Linked Heap",
+            10,
+            [&] (unsigned iterationCount) {
+                for (unsigned i = iterationCount; i--;)
+                    vm.heap.collectNow(Sync, CollectionScope::Full);
+            });
+
+        // Full collection with a long chain of WeakMap entries, where each entry's value is the
+        // next entry's key and only the first key is otherwise reachable. Compare runs with
+        // JSC_useEphemeronIndex=true and false.
+        globalObject->putDirect(vm, Identifier::fromString(vm, "randomHeap"), jsUndefined());
+        JSWeakMap* weakMap = JSWeakMap::create(vm, globalObject->weakMapStructure());
+        globalObject->putDirect(vm, Identifier::fromString(vm, "ephemeronChain"), weakMap);
+        JSObject* key = JSFinalObject::create(vm, objectStructure);
+        globalObject->putDirect(vm, Identifier::fromString(vm, "ephemeronChainHead"), key);
+        for (unsigned i = 0; i < 20000; ++i) {
+            JSObject* value = JSFinalObject::create(vm, objectStructure);
+            weakMap->set(vm, key, value);
+            key = value;
+        }
+        benchmarkImpl(
+            "Full Collection With Ephemeron Chain",
+            10,
+            [&] (unsigned iterationCount) {
+                for (unsigned i = iterationCount; i--;)
+                    vm.heap.collectNow(Sync, CollectionScope::Full);
+            });
+
+        // Eden collections while many threads that are registered with the heap, but not running JS,
+        // sit on stacks full of words that look like heap pointers. This mostly measures
+        // conservative root scanning, so compare runs with JSC_useMarkedBlockBitmapIndex=true and
+        // false.
+        {
+            constexpr unsigned numberOfThreads = 128;
+            Lock lock;
+            Condition condition;
+            unsigned numberOfReadyThreads = 0;
+            bool shouldStop = false;
+            uintptr_t heapAddress = bitwise_cast<uintptr_t>(object.asCell());
+            Vector<Ref<Thread>> threads;
+            for (unsigned i = 0; i < numberOfThreads; ++i) {
+                threads.append(Thread::create(
+                    "dynbench root scan",
+                    [&, i] {
+                        vm.heap.machineThreads().addCurrentThread();
+                        volatile uintptr_t words[2048];
+                        uint32_t random = i + 1;
+                        for (unsigned j = 0; j < WTF_ARRAY_LENGTH(words); ++j) {
+                            random = random * 1103515245 + 12345;
+                            words[j] = heapAddress + (static_cast<int32_t>(random) >> 4);
+                        }
+                        auto locker = holdLock(lock);
+                        numberOfReadyThreads++;
+                        condition.notifyAll();
+                        condition.wait(lock, [&] { return shouldStop; });
+                    }));
+            }
+            {
+                auto locker = holdLock(lock);
+                condition.wait(lock, [&] { return numberOfReadyThreads == numberOfThreads; });
+            }
+            benchmarkImpl(
+                "Eden Collection With Many Threads",
+                100,
+                [&] (unsigned iterationCount) {
+                    for (unsigned i = iterationCount; i--;)
+                        vm.heap.collectNow(Sync, CollectionScope::Eden);
+                });
+            {
+                auto locker = holdLock(lock);
+                shouldStop = true;
+                condition.notifyAll();
+            }
+            for (auto& thread : threads)
+                thread->waitForCompletion();
+        }
     }
 
     crashLock.lock();
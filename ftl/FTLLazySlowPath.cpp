@@ -62,7 +62,7 @@ void LazySlowPath::generate(CodeBlock* codeBlock)
 
     m_generator->run(jit, params);
 
-    LinkBuffer linkBuffer(jit, codeBlock, JITCompilationMustSucceed);
+    LinkBuffer linkBuffer(jit, codeBlock, JITCompilationMustSucceed, JITCodePlacement::Cold);
     linkBuffer.link(params.doneJumps, m_done);
     if (m_exceptionTarget)
         linkBuffer.link(exceptionJumps, m_exceptionTarget);
@@ -42,6 +42,7 @@
 #include "MaxFrameExtentForSlowPathCall.h"
 #include "OperandsInlines.h"
 #include "ProbeContext.h"
+#include "ProfilerLifecycleLog.h"
 
 #include <wtf/Scope.h>
 
@@ -538,7 +539,7 @@ static void compileStub(VM& vm, unsigned exitID, JITCode* jitCode, OSRExit& exit
     reifyInlinedCallFrames(jit, exit);
     adjustAndJumpToTarget(vm, jit, exit);
     
-    LinkBuffer patchBuffer(jit, codeBlock);
+    LinkBuffer patchBuffer(jit, codeBlock, JITCompilationMustSucceed, JITCodePlacement::Cold);
     exit.m_code = FINALIZE_CODE_IF(
         shouldDumpDisassembly() || Options::verboseOSR() || Options::verboseFTLOSRExit(),
         patchBuffer, OSRExitPtrTag,
@@ -576,6 +577,12 @@ JSC_DEFINE_JIT_OPERATION(operationCompileFTLOSRExit, void*, (CallFrame* callFram
 
     JITCode* jitCode = codeBlock->jitCode()->ftl();
     OSRExit& exit = jitCode->osrExit[exitID];
+
+    if (UNLIKELY(Profiler::LifecycleLog::isEnabled())) {
+        const CodeOrigin& origin = exit.m_codeOriginForExitProfile;
+        CodeBlock* profiledBlock = baselineCodeBlockForOriginAndBaselineCodeBlock(origin, codeBlock->baselineAlternative());
+        Profiler::logLifecycleEvent(profiledBlock, Profiler::LifecycleEventKind::OSRExit, JITType::FTLJIT, origin.bytecodeIndex(), exit.m_kind);
+    }
     
     if (shouldDumpDisassembly() || Options::verboseOSR() || Options::verboseFTLOSRExit()) {
         dataLog("    Owning block: ", pointerDump(codeBlock), "\n");
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "AllocationSiteProfiler.h"
+
+#include "DeferGC.h"
+#include "HeapCell.h"
+#include "JSCInlines.h"
+#include "StackVisitor.h"
+#include <wtf/SetForScope.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+AllocationSiteProfiler::AllocationSiteProfiler(size_t samplingInterval, unsigned stackDepth)
+    : m_samplingInterval(samplingInterval)
+    , m_stackDepth(std::max(stackDepth, 1u))
+{
+    RELEASE_ASSERT(m_samplingInterval);
+    scheduleNextSample();
+}
+
+void AllocationSiteProfiler::scheduleNextSample()
+{
+    // Jitter the interval so that a program that allocates in a fixed pattern does not always get
+    // sampled at the same site.
+    m_bytesUntilNextSample = std::max<size_t>(static_cast<size_t>(m_samplingInterval * (0.5 + m_random.get())), 1);
+}
+
+String AllocationSiteProfiler::captureStack(VM& vm)
+{
+    StringBuilder stack;
+    unsigned depth = 0;
+    if (vm.topCallFrame) {
+        StackVisitor::visit(vm.topCallFrame, vm, [&] (StackVisitor& visitor) -> StackVisitor::Status {
+            String frame = visitor->toString();
+            if (frame.isEmpty())
+                return StackVisitor::Continue;
+            if (depth)
+                stack.append('\n');
+            stack.append(frame);
+            return ++depth < m_stackDepth ? StackVisitor::Continue : StackVisitor::Done;
+        });
+    }
+    if (!depth)
+        return "(no JavaScript frames)"_s;
+    return stack.toString();
+}
+
+void AllocationSiteProfiler::recordSample(VM& vm, HeapCell* cell, size_t cellSize)
+{
+    scheduleNextSample();
+
+    // Walking the stack may compute function names, which must not allocate in a way that gets us
+    // back here or lets the collector run while the cell we are sampling is uninitialized.
+    if (m_isCapturingStack)
+        return;
+    SetForScope<bool> isCapturingStack(m_isCapturingStack, true);
+    DeferGCForAWhile deferGC(vm.heap);
+
+    String stack = captureStack(vm);
+
+    auto locker = holdLock(m_lock);
+    auto addResult = m_siteIndices.add(stack, m_sites.size());
+    if (addResult.isNewEntry)
+        m_sites.append(Site { WTFMove(stack) });
+    unsigned siteIndex = addResult.iterator->value;
+    Site& site = m_sites[siteIndex];
+    size_t weight = std::max(m_samplingInterval, cellSize);
+    site.allocatedBytes += weight;
+    site.retainedBytes += weight;
+    site.sampledCellBytes += cellSize;
+    site.numberOfSamples++;
+    site.numberOfLiveSamples++;
+    m_liveSamples.append(Sample { cell, weight, siteIndex, 0 });
+}
+
+void AllocationSiteProfiler::didFinishMarking()
+{
+    auto locker = holdLock(m_lock);
+    for (Site& site : m_sites) {
+        site.retainedBytes = 0;
+        site.numberOfLiveSamples = 0;
+    }
+
+    unsigned liveCount = 0;
+    for (Sample& sample : m_liveSamples) {
+        if (!sample.cell->isLive())
+            continue;
+        sample.survivedCollections++;
+        Site& site = m_sites[sample.siteIndex];
+        site.retainedBytes += sample.weight;
+        site.numberOfLiveSamples++;
+        site.maxSurvivedCollections = std::max(site.maxSurvivedCollections, sample.survivedCollections);
+        m_liveSamples[liveCount++] = sample;
+    }
+    m_liveSamples.shrink(liveCount);
+}
+
+Vector<AllocationSiteProfiler::Site> AllocationSiteProfiler::topSites(unsigned limit) const
+{
+    Vector<Site> sites;
+    {
+        auto locker = holdLock(m_lock);
+        sites = m_sites;
+    }
+    std::sort(sites.begin(), sites.end(), [] (const Site& a, const Site& b) {
+        if (a.retainedBytes != b.retainedBytes)
+            return a.retainedBytes > b.retainedBytes;
+        return a.allocatedBytes > b.allocatedBytes;
+    });
+    if (sites.size() > limit)
+        sites.shrink(limit);
+    return sites;
+}
+
+String AllocationSiteProfiler::toJSON(unsigned limit) const
+{
+    StringBuilder json;
+    json.append("{\"samplingInterval\":", m_samplingInterval, ",\"sites\":[");
+    bool first = true;
+    for (const Site& site : topSites(limit)) {
+        if (!first)
+            json.append(',');
+        first = false;
+        json.append("{\"stack\":");
+        json.appendQuotedJSONString(site.stack);
+        json.append(",\"allocatedBytes\":", site.allocatedBytes);
+        json.append(",\"retainedBytes\":", site.retainedBytes);
+        json.append(",\"averageCellSize\":", site.averageCellSize());
+        json.append(",\"samples\":", site.numberOfSamples);
+        json.append(",\"liveSamples\":", site.numberOfLiveSamples);
+        json.append(",\"maxSurvivedCollections\":", site.maxSurvivedCollections);
+        json.append('}');
+    }
+    json.append("]}");
+    return json.toString();
+}
+
+} // namespace JSC
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include <wtf/FastMalloc.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+#include <wtf/WeakRandom.h>
+#include <wtf/text/StringHash.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class HeapCell;
+class VM;
+
+// Samples roughly one allocation per Options::allocationSamplingInterval() bytes and remembers the
+// JS stack that allocated it. Samples are only taken on the allocation slow paths (free list
+// refills and precise allocations), so when the profiler is off the fast path is unaffected, and
+// when it is on the cost is one stack walk per sampling interval. Each sample stands for an
+// interval's worth of bytes, or for its own size if that is larger. After every collection,
+// samples whose cells died are dropped, which gives an estimate of how many bytes each allocation
+// site is retaining.
+class AllocationSiteProfiler {
+    WTF_MAKE_NONCOPYABLE(AllocationSiteProfiler);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    struct Site {
+        String stack;
+        size_t allocatedBytes { 0 };
+        size_t retainedBytes { 0 };
+        size_t sampledCellBytes { 0 };
+        unsigned numberOfSamples { 0 };
+        unsigned numberOfLiveSamples { 0 };
+        unsigned maxSurvivedCollections { 0 };
+
+        size_t averageCellSize() const { return numberOfSamples ? sampledCellBytes / numberOfSamples : 0; }
+    };
+
+    AllocationSiteProfiler(size_t samplingInterval, unsigned stackDepth);
+
+    // Called on the allocation slow paths with the number of bytes just handed to the allocator.
+    // Returns true if the cell being allocated should be sampled.
+    bool didAllocate(size_t bytes)
+    {
+        if (LIKELY(bytes < m_bytesUntilNextSample)) {
+            m_bytesUntilNextSample -= bytes;
+            return false;
+        }
+        return true;
+    }
+    void recordSample(VM&, HeapCell*, size_t cellSize);
+
+    // Called by the collector after marking and before sweeping.
+    void didFinishMarking();
+
+    // Returns sites sorted by retained bytes, largest first.
+    JS_EXPORT_PRIVATE Vector<Site> topSites(unsigned limit) const;
+    JS_EXPORT_PRIVATE String toJSON(unsigned limit) const;
+
+private:
+    struct Sample {
+        HeapCell* cell;
+        size_t weight;
+        unsigned siteIndex;
+        unsigned survivedCollections;
+    };
+
+    String captureStack(VM&);
+    void scheduleNextSample();
+
+    size_t m_samplingInterval;
+    unsigned m_stackDepth;
+    size_t m_bytesUntilNextSample { 0 };
+    WeakRandom m_random;
+    bool m_isCapturingStack { false };
+
+    mutable Lock m_lock;
+    HashMap<String, unsigned> m_siteIndices;
+    Vector<Site> m_sites;
+    Vector<Sample> m_liveSamples;
+};
+
+} // namespace JSC
@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "ArrayCardTable.h"
+
+#include "JSCInlines.h"
+#include "SlotVisitorInlines.h"
+
+namespace JSC {
+
+bool ArrayCardTable::dirty(JSObject* object, unsigned index)
+{
+    Butterfly* butterfly = object->butterfly();
+    unsigned vectorLength;
+    switch (object->indexingType()) {
+    case ALL_CONTIGUOUS_INDEXING_TYPES:
+        vectorLength = butterfly->vectorLength();
+        break;
+    case ALL_ARRAY_STORAGE_INDEXING_TYPES:
+        vectorLength = butterfly->arrayStorage()->vectorLength();
+        break;
+    default:
+        return false;
+    }
+    if (vectorLength < Options::minimumArrayLengthForCardMarking() || index >= vectorLength)
+        return false;
+
+    size_t card = index >> log2ElementsPerCard;
+
+    // Only the mutator dirties cards, and the collector only takes or clears them while the world
+    // is stopped, so the mutator can check the cards of the last object it dirtied without the lock.
+    // A marked array stays black while it has dirty cards, so every store into it comes back here.
+    if (object == m_lastObject && m_lastCards->get(card))
+        return true;
+
+    auto locker = holdLock(m_lock);
+    if (object != m_lastObject) {
+        m_lastCards = &m_dirtyCards.add(object, BitVector()).iterator->value;
+        m_lastObject = object;
+    }
+    m_lastCards->set(card);
+    return true;
+}
+
+void ArrayCardTable::visitDirtyCards(SlotVisitor& visitor)
+{
+    HashMap<JSObject*, BitVector> dirtyCards;
+    {
+        auto locker = holdLock(m_lock);
+        dirtyCards = WTFMove(m_dirtyCards);
+        m_lastObject = nullptr;
+        m_lastCards = nullptr;
+    }
+
+    for (auto& entry : dirtyCards) {
+        JSObject* object = entry.key;
+        ASSERT(visitor.heap()->isMarked(object));
+
+        // If the array changed shape or got a new butterfly since the card was dirtied, then the
+        // object's own barrier fired and the whole object gets rescanned anyway. Cards that are
+        // past the end of the current vector no longer hold anything.
+        Butterfly* butterfly = object->butterfly();
+        WriteBarrier<Unknown>* elements;
+        unsigned length;
+        switch (object->indexingType()) {
+        case ALL_CONTIGUOUS_INDEXING_TYPES:
+            elements = butterfly->contiguous().data();
+            length = butterfly->publicLength();
+            break;
+        case ALL_ARRAY_STORAGE_INDEXING_TYPES:
+            elements = butterfly->arrayStorage()->m_vector;
+            length = butterfly->arrayStorage()->vectorLength();
+            break;
+        default:
+            continue;
+        }
+
+        for (size_t card : entry.value) {
+            size_t begin = card << log2ElementsPerCard;
+            if (begin >= length)
+                break;
+            size_t end = std::min<size_t>(begin + elementsPerCard, length);
+            visitor.appendValuesHidden(elements + begin, end - begin);
+        }
+    }
+}
+
+void ArrayCardTable::clear()
+{
+    auto locker = holdLock(m_lock);
+    m_dirtyCards.clear();
+    m_lastObject = nullptr;
+    m_lastCards = nullptr;
+}
+
+} // namespace JSC
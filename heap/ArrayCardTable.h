@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include <wtf/BitVector.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Noncopyable.h>
+
+namespace JSC {
+
+class JSObject;
+class SlotVisitor;
+
+// A card-marking remembered set for the elements of large arrays. When the mutator stores a cell
+// into an element of a large, already marked Contiguous or ArrayStorage array from the runtime,
+// it dirties the card holding that element instead of putting the whole array back on the mark
+// stack. The "Ac" marking constraint then rescans only the dirty cards, so an Eden collection
+// does not have to rescan a huge long-lived array because one element changed.
+//
+// Stores that go through the object's regular write barrier, like those from JIT code, still
+// remember the whole object. The two are complementary: a dirty card only matters while the
+// object itself is black.
+class ArrayCardTable {
+    WTF_MAKE_NONCOPYABLE(ArrayCardTable);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static constexpr unsigned log2ElementsPerCard = 7;
+    static constexpr unsigned elementsPerCard = 1 << log2ElementsPerCard;
+
+    ArrayCardTable() = default;
+
+    // Returns false if the object does not use cards, in which case the caller has to remember
+    // the whole object.
+    bool dirty(JSObject*, unsigned index);
+
+    // Must be called with the world stopped. Visits the elements of all dirty cards and cleans them.
+    void visitDirtyCards(SlotVisitor&);
+
+    void clear();
+
+private:
+    Lock m_lock;
+    HashMap<JSObject*, BitVector> m_dirtyCards;
+    JSObject* m_lastObject { nullptr };
+    BitVector* m_lastCards { nullptr };
+};
+
+} // namespace JSC
@@ -27,7 +27,9 @@
 #include "BlockDirectory.h"
 
 #include "BlockDirectoryInlines.h"
+#include "ConcurrentSweeper.h"
 #include "Heap.h"
+#include "MarkedBlockInlines.h"
 #include "SubspaceInlines.h"
 #include "SuperSampler.h"
 
@@ -162,6 +164,10 @@ void BlockDirectory::removeBlock(MarkedBlock::Handle* block, WillDeleteBlock wil
     ASSERT(block->directory() == this);
     ASSERT(m_blocks[block->index()] == block);
     
+    // Make sure that no heap helper is still building a free list in this block.
+    if (block->hasConcurrentSweepSlot())
+        markedSpace().heap().concurrentSweeper().claim(*block);
+    
     subspace()->didRemoveBlock(block->index());
     
     m_blocks[block->index()] = nullptr;
@@ -255,7 +261,8 @@ void BlockDirectory::endMarking()
     // vectors.
     
     m_bits.empty() = m_bits.live() & ~m_bits.markingNotEmpty();
-    m_bits.canAllocateButNotEmpty() = m_bits.live() & m_bits.markingNotEmpty() & ~m_bits.markingRetired();
+    updateDrainingBlocks();
+    m_bits.canAllocateButNotEmpty() = m_bits.live() & m_bits.markingNotEmpty() & ~m_bits.markingRetired() & ~m_bits.draining();
 
     if (needsDestruction()) {
         // There are some blocks that we didn't allocate out of in the last cycle, but we swept them. This
@@ -272,6 +279,54 @@ void BlockDirectory::endMarking()
     }
 }
 
+void BlockDirectory::updateDrainingBlocks()
+{
+    // We never move objects, so the only way to get rid of a sparse block is to stop allocating into
+    // it and wait for the objects that are left in it to die. Once that happens, the block is empty
+    // and the incremental sweeper gives it back to the AlignedMemoryAllocator. Blocks that are
+    // empty now can be allocated into again.
+    if (!Options::useSparseBlockDraining()) {
+        m_bits.draining().clearAll();
+        return;
+    }
+
+    m_bits.draining() = m_bits.draining() & m_bits.markingNotEmpty();
+
+    if (needsDestruction() || m_subspace->isIsoSubspace())
+        return;
+
+    // Only a full collection tells us how much of each block is really live.
+    if (markedSpace().heap().collectionScope() != CollectionScope::Full)
+        return;
+
+    m_bits.draining().clearAll();
+
+    size_t liveCells = 0;
+    size_t capacityInCells = 0;
+    Vector<MarkedBlock::Handle*, 32> sparseBlocks;
+    double maxBlockUtilization = Options::maxMarkedBlockUtilizationForDraining();
+    (m_bits.markingNotEmpty() & ~m_bits.markingRetired()).forEachSetBit(
+        [&] (size_t index) {
+            MarkedBlock::Handle* block = m_blocks[index];
+            size_t markCount = block->markCount();
+            unsigned cellsPerBlock = block->cellsPerBlock();
+            liveCells += markCount;
+            capacityInCells += cellsPerBlock;
+            if (markCount < maxBlockUtilization * cellsPerBlock)
+                sparseBlocks.append(block);
+        });
+
+    // Draining makes the heap grow until the sparse blocks empty out, so only do it if enough of this
+    // directory is wasted for that to pay off.
+    if (!capacityInCells || static_cast<double>(liveCells) / capacityInCells > Options::maxDirectoryUtilizationForDraining())
+        return;
+
+    for (MarkedBlock::Handle* block : sparseBlocks)
+        m_bits.setIsDraining(block->index(), true);
+
+    dataLogLnIf(Options::logGC() == GCLogging::Verbose, "Draining ", sparseBlocks.size(), " sparse blocks for ", m_cellSize, ", ", m_attributes, " (", liveCells, "/", capacityInCells, " cells live)");
+}
+
 void BlockDirectory::snapshotUnsweptForEdenCollection()
 {
     m_bits.unswept() |= m_bits.eden();
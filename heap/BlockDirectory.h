@@ -149,6 +149,8 @@ private:
     
     MarkedBlock::Handle* tryAllocateBlock(Heap&);
     
+    void updateDrainingBlocks();
+    
     Vector<MarkedBlock::Handle*> m_blocks;
     Vector<unsigned> m_freeBlockIndices;
 
@@ -27,6 +27,7 @@
 #include "Subspace.h"
 
 #include "AlignedMemoryAllocator.h"
+#include "AllocationSiteProfiler.h"
 #include "AllocatorInlines.h"
 #include "JSCellInlines.h"
 #include "LocalAllocatorInlines.h"
@@ -149,6 +150,10 @@ void* CompleteSubspace::tryAllocateSlow(VM& vm, size_t size, GCDeferralContext*
     m_space.m_capacity += size;
     
     m_preciseAllocations.append(allocation);
+
+    AllocationSiteProfiler* profiler = vm.heap.allocationSiteProfiler();
+    if (UNLIKELY(profiler) && profiler->didAllocate(size))
+        profiler->recordSample(vm, allocation->cell(), size);
         
     return allocation->cell();
 }
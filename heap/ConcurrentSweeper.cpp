@@ -0,0 +1,181 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "ConcurrentSweeper.h"
+
+#include "BlockDirectoryInlines.h"
+#include "HeapCellType.h"
+#include "HeapHelperPool.h"
+#include "HeapInlines.h"
+#include "MarkedBlockInlines.h"
+#include "Options.h"
+#include "Subspace.h"
+
+namespace JSC {
+
+namespace ConcurrentSweeperInternal {
+static constexpr bool verbose = false;
+}
+
+ConcurrentSweeper::ConcurrentSweeper(Heap& heap)
+    : m_heap(heap)
+    , m_helperClient(&heapHelperPool())
+{
+}
+
+ConcurrentSweeper::~ConcurrentSweeper()
+{
+    RELEASE_ASSERT(!isSweeping());
+}
+
+bool ConcurrentSweeper::isEligible(BlockDirectory& directory, MarkedBlock::Handle* block)
+{
+    bool needsDestruction = directory.needsDestruction();
+    if (needsDestruction) {
+        if (!Options::useConcurrentDestruction() || !directory.subspace()->heapCellType()->hasThreadSafeDestructor())
+            return false;
+    } else {
+        if (!Options::useConcurrentSweeping())
+            return false;
+        if (directory.subspace()->isIsoSubspace())
+            return false;
+    }
+    if (block->isFreeListed() || block->m_concurrentSweepSlot)
+        return false;
+    if (!block->weakSet().isEmpty())
+        return false;
+    return directory.isUnswept(NoLockingNecessary, block)
+        && directory.isCanAllocateButNotEmpty(NoLockingNecessary, block)
+        && !directory.isEmpty(NoLockingNecessary, block)
+        && (needsDestruction || !directory.isDestructible(NoLockingNecessary, block));
+}
+
+void ConcurrentSweeper::startSweeping()
+{
+    RELEASE_ASSERT(!isSweeping());
+
+    Vector<MarkedBlock::Handle*> blocks;
+    for (BlockDirectory* directory = m_heap.objectSpace().firstDirectory(); directory; directory = directory->nextDirectory()) {
+        directory->forEachBlock(
+            [&] (MarkedBlock::Handle* block) {
+                if (isEligible(*directory, block))
+                    blocks.append(block);
+            });
+    }
+
+    dataLogLnIf(ConcurrentSweeperInternal::verbose, "ConcurrentSweeper: starting with ", blocks.size(), " blocks.");
+
+    if (blocks.isEmpty())
+        return;
+
+    m_slots = makeUniqueArray<Slot>(blocks.size());
+    m_numSlots = blocks.size();
+    for (unsigned i = 0; i < m_numSlots; ++i) {
+        m_slots[i].block = blocks[i];
+        if (blocks[i]->needsDestruction())
+            m_slots[i].destructorCellType = blocks[i]->subspace()->heapCellType();
+        blocks[i]->m_concurrentSweepSlot = i + 1;
+    }
+    m_nextSlot.store(0);
+    m_shouldStop.store(false);
+
+    m_helperClient.setFunction(
+        [this] () {
+            doSomeSweeping();
+        });
+}
+
+void ConcurrentSweeper::stopSweeping()
+{
+    if (!isSweeping())
+        return;
+
+    m_shouldStop.store(true);
+    m_helperClient.finish();
+
+    // Whatever the mutator did not claim goes back to being an ordinary unswept block. The helper
+    // only wrote into dead cells, so there is nothing to undo. If it destroyed them, it also zapped
+    // them, so the next sweep of the block will not destroy them again.
+    unsigned numClaimed = 0;
+    for (unsigned i = 0; i < m_numSlots; ++i) {
+        Slot& slot = m_slots[i];
+        if (slot.state.load() == SlotState::Claimed) {
+            numClaimed++;
+            continue;
+        }
+        slot.block->m_concurrentSweepSlot = 0;
+    }
+
+    dataLogLnIf(ConcurrentSweeperInternal::verbose, "ConcurrentSweeper: stopping, mutator claimed ", numClaimed, " of ", m_numSlots, " blocks.");
+
+    m_slots = nullptr;
+    m_numSlots = 0;
+}
+
+void ConcurrentSweeper::doSomeSweeping()
+{
+    while (!m_shouldStop.load()) {
+        unsigned index = m_nextSlot.exchangeAdd(1);
+        if (index >= m_numSlots)
+            return;
+
+        Slot& slot = m_slots[index];
+        if (!slot.state.compareExchangeStrong(SlotState::Idle, SlotState::Sweeping))
+            continue;
+
+        slot.block->sweepConcurrently(slot.freeList, slot.destructorCellType);
+        slot.state.store(SlotState::Swept);
+    }
+}
+
+Optional<PreSweptFreeList> ConcurrentSweeper::claim(MarkedBlock::Handle& block)
+{
+    ASSERT(block.m_concurrentSweepSlot);
+    Slot& slot = m_slots[block.m_concurrentSweepSlot - 1];
+    ASSERT(slot.block == &block);
+    block.m_concurrentSweepSlot = 0;
+
+    for (;;) {
+        switch (slot.state.load()) {
+        case SlotState::Idle:
+            if (slot.state.compareExchangeStrong(SlotState::Idle, SlotState::Claimed))
+                return WTF::nullopt;
+            break;
+        case SlotState::Sweeping:
+            // A helper is halfway through this block. It will be done soon.
+            Thread::yield();
+            break;
+        case SlotState::Swept:
+            slot.state.store(SlotState::Claimed);
+            return slot.freeList;
+        case SlotState::Claimed:
+            RELEASE_ASSERT_NOT_REACHED();
+            return WTF::nullopt;
+        }
+    }
+}
+
+} // namespace JSC
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "MarkedBlock.h"
+#include <wtf/Atomics.h>
+#include <wtf/Optional.h>
+#include <wtf/ParallelHelperPool.h>
+#include <wtf/UniqueArray.h>
+
+namespace JSC {
+
+class Heap;
+class HeapCellType;
+struct FreeCell;
+
+// A free list that was built by a helper thread but not yet installed into its block. Building
+// it only writes into dead cells, so nothing about the block changes until the mutator claims it.
+struct PreSweptFreeList {
+    FreeCell* head { nullptr };
+    uintptr_t secret { 0 };
+    unsigned bytes { 0 };
+    bool hadNewlyAllocated { false };
+    bool isEmpty { false };
+};
+
+// The ConcurrentSweeper lets HeapHelperPool threads build free lists for unswept blocks right
+// after a collection, so that the allocator's slow path can install them instead of sweeping
+// inline. Only blocks that have no weak handles are eligible. Blocks that need destruction are
+// only eligible with Options::useConcurrentDestruction(), and only if their HeapCellType says
+// that the destructor is thread-safe; the helper then runs the destructors of the block's dead
+// cells as it builds the free list.
+//
+// Every eligible block gets a slot, and whoever wins the slot owns the block's cells:
+//
+// - Helpers move a slot from Idle to Sweeping and then to Swept.
+// - The mutator moves a slot to Claimed whenever it wants to sweep the block to a free list or
+//   remove it from its directory. If the slot was Swept, the mutator installs the pre-swept free
+//   list. If it was Sweeping, the mutator waits for the helper to finish first.
+//
+// All of this has to be over before the collector touches the heap again, so the Heap calls
+// stopSweeping() whenever it stops allocating.
+class ConcurrentSweeper {
+    WTF_MAKE_NONCOPYABLE(ConcurrentSweeper);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    ConcurrentSweeper(Heap&);
+    ~ConcurrentSweeper();
+
+    void startSweeping();
+    void stopSweeping();
+
+    bool isSweeping() const { return !!m_numSlots; }
+
+    // Only call this on the mutator, and only for a block that has a slot. Once this returns, no
+    // helper is touching the block.
+    Optional<PreSweptFreeList> claim(MarkedBlock::Handle&);
+
+private:
+    enum class SlotState : uint8_t {
+        Idle,
+        Sweeping,
+        Swept,
+        Claimed
+    };
+
+    struct Slot {
+        MarkedBlock::Handle* block { nullptr };
+        HeapCellType* destructorCellType { nullptr };
+        Atomic<SlotState> state { SlotState::Idle };
+        PreSweptFreeList freeList;
+    };
+
+    bool isEligible(BlockDirectory&, MarkedBlock::Handle*);
+    void doSomeSweeping();
+
+    Heap& m_heap;
+    ParallelHelperClient m_helperClient;
+    UniqueArray<Slot> m_slots;
+    unsigned m_numSlots { 0 };
+    Atomic<unsigned> m_nextSlot { 0 };
+    Atomic<bool> m_shouldStop { false };
+};
+
+} // namespace JSC
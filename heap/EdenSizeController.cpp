@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "EdenSizeController.h"
+
+#include "Options.h"
+#include <wtf/DataLog.h>
+
+namespace JSC {
+
+namespace EdenSizeControllerInternal {
+static constexpr bool verbose = false;
+}
+
+namespace {
+
+// Below this survival rate Eden collections are cheap and the budget grows; above the high rate it
+// shrinks.
+constexpr double lowSurvivalRate = 0.1;
+constexpr double highSurvivalRate = 0.3;
+// How much of the latest survival rate goes into the running average.
+constexpr double survivalRateWeight = 0.5;
+constexpr double growthPerCollection = 1.5;
+constexpr double shrinkPerCollection = 0.5;
+constexpr double minimumScale = 0.25;
+
+} // anonymous namespace
+
+EdenSizeController::EdenSizeController(size_t minimumEdenBudget)
+    : m_minimumEdenBudget(minimumEdenBudget)
+{
+}
+
+void EdenSizeController::didPause(Seconds pause)
+{
+    m_maxPauseThisCycle = std::max(m_maxPauseThisCycle, pause);
+}
+
+void EdenSizeController::didFinishCollection(CollectionScope scope, size_t bytesAllocated, size_t bytesSurvived, Seconds finalPause)
+{
+    Seconds maxPause = std::max(m_maxPauseThisCycle, finalPause);
+
+    // Full collections visit the whole heap, so they tell us nothing about Eden.
+    if (scope != CollectionScope::Eden || !bytesAllocated)
+        return;
+
+    double survivalRate = std::min(1.0, static_cast<double>(bytesSurvived) / bytesAllocated);
+    if (m_hasSurvivalRate)
+        m_survivalRate = survivalRateWeight * survivalRate + (1 - survivalRateWeight) * m_survivalRate;
+    else
+        m_survivalRate = survivalRate;
+    m_hasSurvivalRate = true;
+
+    Seconds pauseTarget = Seconds::fromMilliseconds(Options::edenPauseTargetMS());
+    if (maxPause > pauseTarget || m_survivalRate > highSurvivalRate) {
+        double shrink = shrinkPerCollection;
+        if (maxPause > pauseTarget)
+            shrink = std::min(shrink, pauseTarget / maxPause);
+        m_scale = std::max(minimumScale, m_scale * shrink);
+    } else if (m_survivalRate < lowSurvivalRate) {
+        double growth = growthPerCollection;
+        if (maxPause)
+            growth = std::min(growth, pauseTarget / maxPause);
+        m_scale = std::min(Options::maximumEdenGrowthFactor(), m_scale * growth);
+    }
+
+    dataLogLnIf(EdenSizeControllerInternal::verbose, "Eden: survivalRate = ", survivalRate, " (average ", m_survivalRate, "), maxPause = ", maxPause, ", scale = ", m_scale);
+}
+
+size_t EdenSizeController::edenBudget(size_t proposedBudget) const
+{
+    size_t budget = static_cast<size_t>(proposedBudget * m_scale);
+    if (m_scale < 1)
+        budget = std::max(budget, std::min(proposedBudget, m_minimumEdenBudget));
+    return budget;
+}
+
+} // namespace JSC
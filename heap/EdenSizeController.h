@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "CollectionScope.h"
+#include <wtf/FastMalloc.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Seconds.h>
+
+namespace JSC {
+
+// Scales the Eden budget that Heap::updateAllocationLimits() picks, based on how the recent Eden
+// collections went. Few survivors mean Eden collections are cheap, so the budget grows and we
+// collect less often. Many survivors, or pauses over Options::edenPauseTargetMS(), mean the next
+// collection would be expensive, so the budget shrinks. We assume that pause times grow with the
+// number of survivors, and so with the size of Eden; the budget never grows by more than that
+// assumption allows before the pause target is hit.
+class EdenSizeController {
+    WTF_MAKE_NONCOPYABLE(EdenSizeController);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // A shrinking budget never drops below minimumEdenBudget, unless it was already smaller.
+    explicit EdenSizeController(size_t minimumEdenBudget);
+
+    void willStartCollection() { m_maxPauseThisCycle = Seconds(); }
+    void didPause(Seconds);
+    // bytesSurvived is how much the heap grew during the collection, which for Eden collections
+    // is the size of the survivors. finalPause is the pause that is still in progress.
+    void didFinishCollection(CollectionScope, size_t bytesAllocated, size_t bytesSurvived, Seconds finalPause);
+
+    size_t edenBudget(size_t proposedBudget) const;
+
+    double scale() const { return m_scale; }
+    double survivalRate() const { return m_survivalRate; }
+
+private:
+    size_t m_minimumEdenBudget;
+    double m_scale { 1 };
+    double m_survivalRate { 0 };
+    bool m_hasSurvivalRate { false };
+    Seconds m_maxPauseThisCycle;
+};
+
+} // namespace JSC
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "EphemeronTable.h"
+
+#include "JSCInlines.h"
+
+namespace JSC {
+
+bool EphemeronTable::shouldIndex(JSCell* map)
+{
+    auto locker = holdLock(m_lock);
+    return m_indexedMaps.add(map).isNewEntry;
+}
+
+void EphemeronTable::addPendingValues(const Vector<std::pair<JSCell*, JSValue>>& entries)
+{
+    if (entries.isEmpty())
+        return;
+
+    auto locker = holdLock(m_lock);
+    for (auto& entry : entries) {
+        m_pendingValues.add(entry.first, Vector<JSValue, 1>()).iterator->value.append(entry.second);
+        m_keys.add(entry.first);
+    }
+    m_mayHavePendingKeys.store(true, std::memory_order_relaxed);
+}
+
+void EphemeronTable::visitValuesForKey(const JSCell* key, SlotVisitor& visitor)
+{
+    Vector<JSValue, 1> values;
+    {
+        auto locker = holdLock(m_lock);
+        values = m_pendingValues.take(key);
+    }
+    // The key stays in m_keys, so later visits of the key find nothing to do here.
+    for (JSValue value : values)
+        visitor.appendUnbarriered(value);
+}
+
+void EphemeronTable::clear()
+{
+    auto locker = holdLock(m_lock);
+    m_keys.clear();
+    m_pendingValues.clear();
+    m_indexedMaps.clear();
+    m_mayHavePendingKeys.store(false, std::memory_order_relaxed);
+}
+
+} // namespace JSC
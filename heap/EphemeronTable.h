@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "JSCJSValue.h"
+#include <wtf/ConcurrentPtrHashSet.h>
+#include <wtf/HashMap.h>
+#include <wtf/HashSet.h>
+#include <wtf/Lock.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+class JSCell;
+class SlotVisitor;
+
+// Indexes the ephemerons (WeakMap entries) whose keys were not marked when their map's output
+// constraint ran, by key. When the marker visits one of these keys, it immediately visits the
+// values that depend on it. This way a chain of entries whose keys only become live one at a time
+// gets marked in a single drain, instead of taking one constraint fixpoint iteration per link.
+//
+// The index only speeds things up: the output constraint still looks at every entry of the
+// marked maps, so entries that the mutator adds during concurrent marking are never missed.
+class EphemeronTable {
+    WTF_MAKE_NONCOPYABLE(EphemeronTable);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    EphemeronTable() = default;
+
+    bool mayHavePendingKeys() const { return m_mayHavePendingKeys.load(std::memory_order_relaxed); }
+
+    // Returns true the first time it is called for a map during a collection. The caller should
+    // then add the map's entries with unmarked keys.
+    bool shouldIndex(JSCell* map);
+    void addPendingValues(const Vector<std::pair<JSCell*, JSValue>>&);
+
+    // Called by the marker when it visits a cell.
+    void didVisitKey(const JSCell* key, SlotVisitor& visitor)
+    {
+        if (m_keys.contains(const_cast<JSCell*>(key)))
+            visitValuesForKey(key, visitor);
+    }
+
+    // Must be called when no marker is visiting cells.
+    void deleteOldTables() { m_keys.deleteOldTables(); }
+    void clear();
+
+private:
+    void visitValuesForKey(const JSCell*, SlotVisitor&);
+
+    ConcurrentPtrHashSet m_keys;
+    std::atomic<bool> m_mayHavePendingKeys { false };
+    Lock m_lock;
+    HashMap<const JSCell*, Vector<JSValue, 1>> m_pendingValues;
+    HashSet<JSCell*> m_indexedMaps;
+};
+
+} // namespace JSC
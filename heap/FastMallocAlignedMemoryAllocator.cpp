@@ -26,6 +26,8 @@
 #include "config.h"
 #include "FastMallocAlignedMemoryAllocator.h"
 
+#include "HugePageBlockAllocator.h"
+#include "Options.h"
 #include <wtf/FastMalloc.h>
 
 namespace JSC {
@@ -35,6 +37,17 @@ FastMallocAlignedMemoryAllocator::FastMallocAlignedMemoryAllocator()
     : m_heap("WebKit FastMallocAlignedMemoryAllocator")
 #endif
 {
+#if !ENABLE(MALLOC_HEAP_BREAKDOWN)
+    if (Options::useHugePagesForMarkedBlocks()) {
+        m_hugePageBlockAllocator = makeUnique<HugePageBlockAllocator>(
+            [] (size_t alignment, size_t size) {
+                return tryFastAlignedMalloc(alignment, size);
+            },
+            [] (void* base) {
+                fastAlignedFree(base);
+            });
+    }
+#endif
 }
 
 FastMallocAlignedMemoryAllocator::~FastMallocAlignedMemoryAllocator()
@@ -46,6 +59,8 @@ void* FastMallocAlignedMemoryAllocator::tryAllocateAlignedMemory(size_t alignmen
 #if ENABLE(MALLOC_HEAP_BREAKDOWN)
     return m_heap.memalign(alignment, size, true);
 #else
+    if (m_hugePageBlockAllocator && alignment == MarkedBlock::blockSize && size == MarkedBlock::blockSize)
+        return m_hugePageBlockAllocator->tryAllocateBlock();
     return tryFastAlignedMalloc(alignment, size);
 #endif
 
@@ -56,6 +71,8 @@ void FastMallocAlignedMemoryAllocator::freeAlignedMemory(void* basePtr)
 #if ENABLE(MALLOC_HEAP_BREAKDOWN)
     return m_heap.free(basePtr);
 #else
+    if (m_hugePageBlockAllocator && m_hugePageBlockAllocator->freeBlock(basePtr))
+        return;
     fastAlignedFree(basePtr);
 #endif
 
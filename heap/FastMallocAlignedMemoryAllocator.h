@@ -33,6 +33,8 @@
 
 namespace JSC {
 
+class HugePageBlockAllocator;
+
 class FastMallocAlignedMemoryAllocator final : public AlignedMemoryAllocator {
 public:
     FastMallocAlignedMemoryAllocator();
@@ -47,9 +49,11 @@ public:
     void freeMemory(void*) final;
     void* tryReallocateMemory(void*, size_t) final;
 
-#if ENABLE(MALLOC_HEAP_BREAKDOWN)
 private:
+#if ENABLE(MALLOC_HEAP_BREAKDOWN)
     WTF::DebugHeap m_heap;
+#else
+    std::unique_ptr<HugePageBlockAllocator> m_hugePageBlockAllocator;
 #endif
 };
 
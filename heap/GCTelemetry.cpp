@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "GCTelemetry.h"
+
+#include <wtf/StringPrintStream.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+static_assert(std::is_trivially_copyable<GCTelemetryRecord>::value, "GCTelemetry readers copy records racily and then validate them");
+
+void GCTelemetryRecord::appendJSON(StringBuilder& json) const
+{
+    json.append("{\"id\":", collectionID);
+    json.append(",\"scope\":\"", collectionScopeName(scope), '"');
+    json.append(",\"startTime\":", startTime.secondsSinceEpoch().milliseconds());
+    json.append(",\"duration\":", duration.milliseconds());
+    json.append(",\"totalPause\":", totalPauseTime.milliseconds());
+    json.append(",\"maxPause\":", maxPauseTime.milliseconds());
+    json.append(",\"constraintSolving\":", constraintSolvingTime.milliseconds());
+    json.append(",\"phases\":{");
+    for (unsigned i = static_cast<unsigned>(CollectorPhase::Begin); i < numberOfCollectorPhases; ++i) {
+        if (i != static_cast<unsigned>(CollectorPhase::Begin))
+            json.append(',');
+        json.append('"', toCString(static_cast<CollectorPhase>(i)).data(), "\":", phaseTimes[i].milliseconds());
+    }
+    json.append('}');
+    json.append(",\"bytesVisited\":", bytesVisited);
+    json.append(",\"heapSizeAfter\":", heapSizeAfterCollection);
+    json.append(",\"blocksSweptBefore\":", blocksSweptSinceLastCollection);
+    json.append('}');
+}
+
+GCTelemetry::GCTelemetry(unsigned capacity)
+    : m_capacity(capacity)
+{
+    if (m_capacity)
+        m_slots = makeUniqueArray<Slot>(m_capacity);
+}
+
+void GCTelemetry::willStartCollection(MonotonicTime now)
+{
+    if (!isEnabled())
+        return;
+    m_current = GCTelemetryRecord();
+    m_current.startTime = now;
+    m_current.blocksSweptSinceLastCollection = m_blocksSweptSinceLastCollection.exchange(0);
+    m_currentPhaseStartTime = now;
+}
+
+void GCTelemetry::didChangePhase(CollectorPhase from, MonotonicTime now)
+{
+    if (!isEnabled() || from == CollectorPhase::NotRunning)
+        return;
+    m_current.phaseTimes[static_cast<unsigned>(from)] += now - m_currentPhaseStartTime;
+    m_currentPhaseStartTime = now;
+}
+
+void GCTelemetry::didResumeAfterPause(Seconds pauseTime)
+{
+    if (!isEnabled())
+        return;
+    m_current.totalPauseTime += pauseTime;
+    m_current.maxPauseTime = std::max(m_current.maxPauseTime, pauseTime);
+}
+
+void GCTelemetry::didFinishCollection(CollectionScope scope, size_t bytesVisited, size_t heapSizeAfterCollection)
+{
+    if (!isEnabled())
+        return;
+    m_current.scope = scope;
+    m_current.bytesVisited = bytesVisited;
+    m_current.heapSizeAfterCollection = heapSizeAfterCollection;
+}
+
+void GCTelemetry::publish(MonotonicTime now)
+{
+    if (!isEnabled())
+        return;
+
+    uint64_t index = m_numberOfRecords.load();
+    m_current.collectionID = index + 1;
+    m_current.duration = now - m_current.startTime;
+
+    Slot& slot = m_slots[index % m_capacity];
+    uint64_t sequence = slot.sequence.load();
+    slot.sequence.store(sequence + 1);
+    WTF::storeStoreFence();
+    slot.record = m_current;
+    WTF::storeStoreFence();
+    slot.sequence.store(sequence + 2);
+    m_numberOfRecords.store(index + 1);
+}
+
+Vector<GCTelemetryRecord> GCTelemetry::copyRecords() const
+{
+    Vector<GCTelemetryRecord> result;
+    if (!isEnabled())
+        return result;
+
+    uint64_t end = m_numberOfRecords.load();
+    uint64_t begin = end > m_capacity ? end - m_capacity : 0;
+    result.reserveInitialCapacity(end - begin);
+    for (uint64_t index = begin; index < end; ++index) {
+        const Slot& slot = m_slots[index % m_capacity];
+        for (unsigned attempts = 0; attempts < 3; ++attempts) {
+            uint64_t sequence = slot.sequence.load();
+            if (sequence & 1)
+                continue;
+            WTF::loadLoadFence();
+            GCTelemetryRecord record = slot.record;
+            WTF::loadLoadFence();
+            if (slot.sequence.load() != sequence)
+                continue;
+            // If the collector lapped us, this slot now holds a newer record. We will see it at the
+            // end of the list or not at all; either way, it does not belong here.
+            if (record.collectionID == index + 1)
+                result.uncheckedAppend(record);
+            break;
+        }
+    }
+    return result;
+}
+
+String GCTelemetry::toJSON() const
+{
+    StringBuilder json;
+    json.append('[');
+    bool first = true;
+    for (const GCTelemetryRecord& record : copyRecords()) {
+        if (!first)
+            json.append(',');
+        first = false;
+        record.appendJSON(json);
+    }
+    json.append(']');
+    return json.toString();
+}
+
+} // namespace JSC
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "CollectionScope.h"
+#include "CollectorPhase.h"
+#include <array>
+#include <wtf/Atomics.h>
+#include <wtf/Forward.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/UniqueArray.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+static constexpr unsigned numberOfCollectorPhases = static_cast<unsigned>(CollectorPhase::End) + 1;
+
+struct GCTelemetryRecord {
+    Seconds phaseTime(CollectorPhase phase) const { return phaseTimes[static_cast<unsigned>(phase)]; }
+
+    void appendJSON(StringBuilder&) const;
+
+    uint64_t collectionID { 0 }; // 1-based. Zero means that this record is invalid.
+    CollectionScope scope { CollectionScope::Eden };
+    MonotonicTime startTime;
+    Seconds duration;
+    Seconds totalPauseTime;
+    Seconds maxPauseTime;
+    Seconds constraintSolvingTime;
+    std::array<Seconds, numberOfCollectorPhases> phaseTimes { };
+    size_t bytesVisited { 0 };
+    size_t heapSizeAfterCollection { 0 };
+    size_t blocksSweptSinceLastCollection { 0 };
+};
+
+// Keeps the last few GCTelemetryRecords in a ring buffer. Only whoever holds the conn writes to
+// it, and collections are serialized, so there is a single writer. Readers may be on any thread
+// and never block the collector: each slot carries a sequence number that is odd while the slot
+// is being written, and readers retry or skip slots that change under them.
+class GCTelemetry {
+    WTF_MAKE_NONCOPYABLE(GCTelemetry);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    GCTelemetry(unsigned capacity);
+
+    bool isEnabled() const { return !!m_capacity; }
+
+    // Called by the collector.
+    void willStartCollection(MonotonicTime now);
+    void didChangePhase(CollectorPhase from, MonotonicTime now);
+    void didResumeAfterPause(Seconds pauseTime);
+    void didExecuteConstraints(Seconds time) { m_current.constraintSolvingTime += time; }
+    void didFinishCollection(CollectionScope, size_t bytesVisited, size_t heapSizeAfterCollection);
+    void publish(MonotonicTime now);
+
+    // Called by whoever sweeps blocks. This may be the mutator or the collector, but never both
+    // at once.
+    void didSweepBlock() { m_blocksSweptSinceLastCollection.exchangeAdd(1, std::memory_order_relaxed); }
+
+    // Safe to call from any thread. Returns records oldest first.
+    JS_EXPORT_PRIVATE Vector<GCTelemetryRecord> copyRecords() const;
+    JS_EXPORT_PRIVATE String toJSON() const;
+
+private:
+    struct Slot {
+        Atomic<uint64_t> sequence { 0 };
+        GCTelemetryRecord record;
+    };
+
+    unsigned m_capacity;
+    UniqueArray<Slot> m_slots;
+    Atomic<uint64_t> m_numberOfRecords { 0 };
+    Atomic<size_t> m_blocksSweptSinceLastCollection { 0 };
+
+    GCTelemetryRecord m_current;
+    MonotonicTime m_currentPhaseStartTime;
+};
+
+} // namespace JSC
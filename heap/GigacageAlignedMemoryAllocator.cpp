@@ -26,6 +26,9 @@
 #include "config.h"
 #include "GigacageAlignedMemoryAllocator.h"
 
+#include "HugePageBlockAllocator.h"
+#include "Options.h"
+
 namespace JSC {
 
 GigacageAlignedMemoryAllocator::GigacageAlignedMemoryAllocator(Gigacage::Kind kind)
@@ -34,6 +37,17 @@ GigacageAlignedMemoryAllocator::GigacageAlignedMemoryAllocator(Gigacage::Kind ki
     , m_heap(makeString("WebKit GigacageAlignedMemoryAllocator ", Gigacage::name(m_kind)).utf8().data())
 #endif
 {
+#if !ENABLE(MALLOC_HEAP_BREAKDOWN)
+    if (Options::useHugePagesForMarkedBlocks()) {
+        m_hugePageBlockAllocator = makeUnique<HugePageBlockAllocator>(
+            [kind] (size_t alignment, size_t size) {
+                return Gigacage::tryAlignedMalloc(kind, alignment, size);
+            },
+            [kind] (void* base) {
+                Gigacage::alignedFree(kind, base);
+            });
+    }
+#endif
 }
 
 GigacageAlignedMemoryAllocator::~GigacageAlignedMemoryAllocator()
@@ -45,6 +59,8 @@ void* GigacageAlignedMemoryAllocator::tryAllocateAlignedMemory(size_t alignment,
 #if ENABLE(MALLOC_HEAP_BREAKDOWN)
     return m_heap.memalign(alignment, size, true);
 #else
+    if (m_hugePageBlockAllocator && alignment == MarkedBlock::blockSize && size == MarkedBlock::blockSize)
+        return m_hugePageBlockAllocator->tryAllocateBlock();
     return Gigacage::tryAlignedMalloc(m_kind, alignment, size);
 #endif
 }
@@ -54,6 +70,8 @@ void GigacageAlignedMemoryAllocator::freeAlignedMemory(void* basePtr)
 #if ENABLE(MALLOC_HEAP_BREAKDOWN)
     return m_heap.free(basePtr);
 #else
+    if (m_hugePageBlockAllocator && m_hugePageBlockAllocator->freeBlock(basePtr))
+        return;
     Gigacage::alignedFree(m_kind, basePtr);
 #endif
 }
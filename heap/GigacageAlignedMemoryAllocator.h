@@ -34,6 +34,8 @@
 
 namespace JSC {
 
+class HugePageBlockAllocator;
+
 class GigacageAlignedMemoryAllocator final : public AlignedMemoryAllocator {
 public:
     GigacageAlignedMemoryAllocator(Gigacage::Kind);
@@ -52,6 +54,8 @@ private:
     Gigacage::Kind m_kind;
 #if ENABLE(MALLOC_HEAP_BREAKDOWN)
     WTF::DebugHeap m_heap;
+#else
+    std::unique_ptr<HugePageBlockAllocator> m_hugePageBlockAllocator;
 #endif
 };
 
@@ -21,13 +21,18 @@
 #include "config.h"
 #include "Heap.h"
 
+#include "AllocationSiteProfiler.h"
+#include "ArrayCardTable.h"
 #include "BuiltinExecutables.h"
 #include "CodeBlock.h"
 #include "CodeBlockSetInlines.h"
 #include "CollectingScope.h"
+#include "ConcurrentSweeper.h"
 #include "ConservativeRoots.h"
 #include "DFGWorklistInlines.h"
 #include "EdenGCActivityCallback.h"
+#include "EdenSizeController.h"
+#include "EphemeronTable.h"
 #include "Exception.h"
 #include "FullGCActivityCallback.h"
 #include "FunctionExecutableInlines.h"
@@ -35,14 +40,17 @@
 #include "GCIncomingRefCountedInlines.h"
 #include "GCIncomingRefCountedSetInlines.h"
 #include "GCSegmentedArrayInlines.h"
+#include "GCTelemetry.h"
 #include "GCTypeMap.h"
 #include "HasOwnPropertyCache.h"
+#include "HeapFootprintController.h"
 #include "HeapHelperPool.h"
 #include "HeapIterationScope.h"
 #include "HeapProfiler.h"
 #include "HeapSnapshot.h"
 #include "HeapVerifier.h"
 #include "IncrementalSweeper.h"
+#include "Integrity.h"
 #include "Interpreter.h"
 #include "IsoCellSetInlines.h"
 #include "JITStubRoutineSet.h"
@@ -59,6 +67,7 @@
 #include "MarkedSpaceInlines.h"
 #include "MarkingConstraintSet.h"
 #include "PreventCollectionScope.h"
+#include "ReleaseHeapAccessScope.h"
 #include "SamplingProfiler.h"
 #include "ShadowChicken.h"
 #include "SpaceTimeMutatorScheduler.h"
@@ -297,6 +306,13 @@ Heap::Heap(VM& vm, HeapType heapType)
     , m_fullActivityCallback(GCActivityCallback::tryCreateFullTimer(this))
     , m_edenActivityCallback(GCActivityCallback::tryCreateEdenTimer(this))
     , m_sweeper(adoptRef(*new IncrementalSweeper(this)))
+    , m_concurrentSweeper(makeUnique<ConcurrentSweeper>(*this))
+    , m_gcTelemetry(makeUnique<GCTelemetry>(Options::numberOfGCTelemetryRecords()))
+    , m_arrayCardTable(makeUnique<ArrayCardTable>())
+    , m_footprintController(makeUnique<HeapFootprintController>(m_minBytesPerCycle / 4))
+    , m_edenSizeController(Options::useEdenSizeAutotuning() ? makeUnique<EdenSizeController>(m_minBytesPerCycle / 4) : nullptr)
+    , m_ephemeronTable(makeUnique<EphemeronTable>())
+    , m_allocationSiteProfiler(Options::allocationSamplingInterval() ? makeUnique<AllocationSiteProfiler>(Options::allocationSamplingInterval(), Options::allocationSamplingStackDepth()) : nullptr)
     , m_stopIfNecessaryTimer(adoptRef(*new StopIfNecessaryTimer(vm)))
     , m_sharedCollectorMarkStack(makeUnique<MarkStackArray>())
     , m_sharedMutatorMarkStack(makeUnique<MarkStackArray>())
@@ -816,6 +832,9 @@ void Heap::endMarking()
     assertMarkStacksEmpty();
 
     RELEASE_ASSERT(m_raceMarkStack->isEmpty());
+
+    // The keys may die now, so the index must not outlive marking.
+    m_ephemeronTable->clear();
     
     m_objectSpace.endMarking();
     setMutatorShouldBeFenced(Options::forceFencedBarrier());
@@ -1256,6 +1275,9 @@ NEVER_INLINE bool Heap::runBeginPhase(GCConductor conn)
     dataLogIf(Options::logGC(), "[GC<", RawPointer(this), ">: START ", gcConductorShortName(conn), " ", capacity() / 1024, "kb ");
 
     m_beforeGC = MonotonicTime::now();
+    m_gcTelemetry->willStartCollection(m_beforeGC);
+    if (m_edenSizeController)
+        m_edenSizeController->willStartCollection();
 
     if (!Options::seedOfVMRandomForFuzzer())
         vm().random().setSeed(cryptographicallyRandomNumber());
@@ -1280,6 +1302,7 @@ NEVER_INLINE bool Heap::runBeginPhase(GCConductor conn)
         
     if (m_collectionScope && m_collectionScope.value() == CollectionScope::Full) {
         m_opaqueRoots.clear();
+        m_arrayCardTable->clear();
         m_collectorSlotVisitor->clearMarkStacks();
         m_mutatorMarkStack->clear();
     }
@@ -1369,6 +1392,7 @@ NEVER_INLINE bool Heap::runFixpointPhase(GCConductor conn)
         
     if (slotVisitor.didReachTermination()) {
         m_opaqueRoots.deleteOldTables();
+        m_ephemeronTable->deleteOldTables();
         
         m_scheduler->didReachTermination();
         
@@ -1382,7 +1406,9 @@ NEVER_INLINE bool Heap::runFixpointPhase(GCConductor conn)
             
         // Wondering what this does? Look at Heap::addCoreConstraints(). The DOM and others can also
         // add their own using Heap::addMarkingConstraint().
+        MonotonicTime constraintsStartTime = MonotonicTime::now();
         bool converged = m_constraintSet->executeConvergence(slotVisitor);
+        m_gcTelemetry->didExecuteConstraints(MonotonicTime::now() - constraintsStartTime);
         
         // FIXME: The slotVisitor.isEmpty() check is most likely not needed.
         // https://bugs.webkit.org/show_bug.cgi?id=180310
@@ -1497,6 +1523,9 @@ NEVER_INLINE bool Heap::runEndPhase(GCConductor conn)
         m_verifier->gatherLiveCells(HeapVerifier::Phase::AfterMarking);
         m_verifier->verify(HeapVerifier::Phase::AfterMarking);
     }
+
+    if (UNLIKELY(Options::auditHeapIntegrity()))
+        Integrity::auditHeap(vm());
         
     {
         auto* previous = Thread::current().setCurrentAtomStringTable(nullptr);
@@ -1507,10 +1536,10 @@ NEVER_INLINE bool Heap::runEndPhase(GCConductor conn)
         if (vm().typeProfiler())
             vm().typeProfiler()->invalidateTypeSetCache(vm());
 
-        m_structureIDTable.flushOldTables();
-
         reapWeakHandles();
         pruneStaleEntriesFromWeakGCMaps();
+        if (m_allocationSiteProfiler)
+            m_allocationSiteProfiler->didFinishMarking();
         sweepArrayBuffers();
         snapshotUnswept();
         finalizeUnconditionalFinalizers(); // We rely on these unconditional finalizers running before clearCurrentlyExecuting since CodeBlock's finalizer relies on querying currently executing.
@@ -1588,6 +1617,8 @@ NEVER_INLINE bool Heap::finishChangingPhase(GCConductor conn)
         dataLog(conn, ": Going to phase: ", m_nextPhase, " (from ", m_currentPhase, ")\n");
     
     m_phaseVersion++;
+
+    m_gcTelemetry->didChangePhase(m_currentPhase, MonotonicTime::now());
     
     bool suspendedBefore = worldShouldBeSuspended(m_currentPhase);
     bool suspendedAfter = worldShouldBeSuspended(m_nextPhase);
@@ -1621,6 +1652,10 @@ NEVER_INLINE bool Heap::finishChangingPhase(GCConductor conn)
     }
     
     m_currentPhase = m_nextPhase;
+
+    // The record is complete once the world has been resumed at the end of the cycle.
+    if (m_currentPhase == CollectorPhase::NotRunning)
+        m_gcTelemetry->publish(MonotonicTime::now());
     return true;
 }
 
@@ -1672,6 +1707,11 @@ NEVER_INLINE void Heap::resumeThePeriphery()
     m_objectSpace.resumeAllocating();
     
     m_barriersExecuted = 0;
+
+    Seconds pause = MonotonicTime::now() - m_stopTime;
+    m_gcTelemetry->didResumeAfterPause(pause);
+    if (m_edenSizeController)
+        m_edenSizeController->didPause(pause);
     
     if (!m_worldIsStopped) {
         dataLog("Fatal: collector does not believe that the world is stopped.\n");
@@ -2145,6 +2185,59 @@ void Heap::waitForCollection(Ticket ticket)
         });
 }
 
+bool Heap::waitForCollectionsUntil(MonotonicTime deadline)
+{
+    // Without heap access, the collector can stop the world whenever it wants to.
+    ReleaseHeapAccessScope releaseHeapAccessScope(*this);
+    for (;;) {
+        {
+            LockHolder locker(*m_threadLock);
+            if (m_lastServedTicket == m_lastGrantedTicket)
+                return true;
+        }
+        if (MonotonicTime::now() >= deadline)
+            return false;
+
+        // The collector unparks m_worldState after serving a ticket. The validation runs under the
+        // ParkingLot's lock, which orders it with that unparkAll(), so we cannot miss the wakeup.
+        ParkingLot::parkConditionally(
+            &m_worldState,
+            [&] () -> bool { return m_lastServedTicket != m_lastGrantedTicket; },
+            [] () { },
+            deadline);
+    }
+}
+
+void Heap::performIdleWork(Seconds budget)
+{
+    MonotonicTime deadline = MonotonicTime::now() + budget;
+    if (!m_isSafeToCollect || isDeferred())
+        return;
+
+    // The mutator is not going to run before the deadline, so the scheduler may keep the world
+    // stopped until then instead of giving the mutator its share of the time.
+    m_scheduler->setIdleDeadline(deadline);
+    auto clearIdleDeadline = makeScopeExit([&] {
+        m_scheduler->setIdleDeadline(MonotonicTime());
+    });
+
+    if (!waitForCollectionsUntil(deadline))
+        return;
+
+    // A collection that runs now is one that will not interrupt the next burst of activity. Only
+    // start one if it is due soon, and if the last one of its kind fit in the time left.
+    Seconds expectedLength = m_shouldDoFullCollection ? m_lastFullGCLength : m_lastEdenGCLength;
+    bool isDueSoon = m_bytesAllocatedThisCycle >= Options::minimumEdenFullnessForIdleCollection() * m_maxEdenSize;
+    if (isDueSoon && MonotonicTime::now() + expectedLength <= deadline) {
+        dataLogLnIf(Options::logGC(), "[GC<", RawPointer(this), ">: starting collection in idle time]");
+        collectAsync();
+        if (!waitForCollectionsUntil(deadline))
+            return;
+    }
+
+    m_sweeper->sweepUntil(vm(), deadline);
+}
+
 void Heap::sweepInFinalize()
 {
     m_objectSpace.sweepPreciseAllocations();
@@ -2244,7 +2337,14 @@ void Heap::notifyIncrementalSweeper()
             m_indexOfNextLogicallyEmptyWeakBlockToSweep = 0;
     }
 
+    bool isOverFootprintTarget = m_footprintController->isOverTarget(HeapFootprintController::SampleMode::Direct);
+    m_sweeper->setSweepsEagerly(isOverFootprintTarget);
+    if (isOverFootprintTarget)
+        m_sweeper->freeFastMallocMemoryAfterSweeping();
+
     m_sweeper->startSweeping(*this);
+    if (Options::useConcurrentSweeping() || Options::useConcurrentDestruction())
+        m_concurrentSweeper->startSweeping();
 }
 
 void Heap::updateAllocationLimits()
@@ -2327,6 +2427,29 @@ void Heap::updateAllocationLimits()
         }
     }
 
+    if (m_edenSizeController) {
+        m_edenSizeController->didFinishCollection(m_collectionScope.valueOr(CollectionScope::Full), m_bytesAllocatedThisCycle, currentHeapSize - std::min(currentHeapSize, m_sizeAfterLastCollect), MonotonicTime::now() - m_stopTime);
+        // Only the budget is scaled. m_maxHeapSize keeps tracking the unscaled nursery, so that
+        // the scaling does not compound from one Eden collection to the next. The footprint cap
+        // below follows the same rule.
+        m_maxEdenSize = m_edenSizeController->edenBudget(m_maxEdenSize);
+        if (verbose)
+            dataLog("Autotuning: survivalRate = ", m_edenSizeController->survivalRate(), ", scale = ", m_edenSizeController->scale(), ", maxEdenSize = ", m_maxEdenSize, "\n");
+    }
+
+    if (m_footprintController->isEnabled()) {
+        // notifyIncrementalSweeper() just sampled the footprint. Cap the next cycle at the headroom
+        // left below the footprint target, and collect fully while we are above it. Like the Eden
+        // size controller, this only lowers the budget: writing the capped value back into
+        // m_maxHeapSize would feed it into the next cycle's budget, which both controllers would
+        // then scale down again.
+        m_maxEdenSize = m_footprintController->edenBudget(m_maxEdenSize);
+        if (m_footprintController->lastFootprint() > m_footprintController->target())
+            m_shouldDoFullCollection = true;
+        if (verbose)
+            dataLog("Footprint: footprint = ", m_footprintController->lastFootprint(), ", maxEdenSize = ", m_maxEdenSize, "\n");
+    }
+
 #if USE(BMALLOC_MEMORY_FOOTPRINT_API)
     // Get critical memory threshold for next cycle.
     overCriticalMemoryThreshold(MemoryThresholdCallType::Direct);
@@ -2361,6 +2484,8 @@ void Heap::didFinishCollection()
     if (UNLIKELY(m_verifier))
         m_verifier->endGC();
 
+    m_gcTelemetry->didFinishCollection(scope, bytesVisited(), m_sizeAfterLastCollect);
+
     RELEASE_ASSERT(m_collectionScope);
     m_lastCollectionScope = m_collectionScope;
     m_collectionScope = WTF::nullopt;
@@ -2567,6 +2692,28 @@ void Heap::writeBarrierSlowPath(const JSCell* from)
     addToRememberedSet(from);
 }
 
+void Heap::writeBarrierForElementSlowPath(const JSCell* from, unsigned index)
+{
+    if (UNLIKELY(mutatorShouldBeFenced())) {
+        WTF::storeLoadFence();
+        if (from->cellState() != CellState::PossiblyBlack)
+            return;
+        // An unmarked black object during a full collection has not been scanned yet, so let
+        // addToRememberedSet re-white it rather than dirtying a card.
+        WTF::loadLoadFence();
+        if (!isMarked(from)) {
+            addToRememberedSet(from);
+            return;
+        }
+    }
+
+    if (!Options::useArrayCardMarking() || !from->isObject() || !m_arrayCardTable->dirty(jsCast<JSObject*>(const_cast<JSCell*>(from)), index)) {
+        addToRememberedSet(from);
+        return;
+    }
+    m_barriersExecuted++;
+}
+
 bool Heap::isCurrentThreadBusy()
 {
     return Thread::mayBeGCThread() || mutatorState() != MutatorState::Running;
@@ -2641,6 +2788,9 @@ void Heap::collectIfNecessaryOrDefer(GCDeferralContext* deferralContext)
             bytesAllowedThisCycle = std::min(m_maxEdenSizeWhenCritical, bytesAllowedThisCycle);
 #endif
 
+        if (m_footprintController->isOverTarget())
+            bytesAllowedThisCycle = m_footprintController->edenBudget(bytesAllowedThisCycle);
+
         if (m_bytesAllocatedThisCycle <= bytesAllowedThisCycle)
             return;
     }
@@ -2866,6 +3016,16 @@ void Heap::addCoreConstraints()
                 });
         },
         ConstraintVolatility::SeldomGreyed);
+
+    if (Options::useArrayCardMarking()) {
+        m_constraintSet->add(
+            "Ac", "Array Cards",
+            [this] (SlotVisitor& slotVisitor) {
+                m_arrayCardTable->visitDirtyCards(slotVisitor);
+            },
+            ConstraintVolatility::GreyedByExecution,
+            ConstraintConcurrency::Sequential);
+    }
     
     m_constraintSet->add(makeUnique<MarkStackMergingConstraint>(*this));
 }
@@ -52,13 +52,20 @@
 
 namespace JSC {
 
+class AllocationSiteProfiler;
+class ArrayCardTable;
 class CodeBlock;
 class CodeBlockSet;
 class CollectingScope;
+class ConcurrentSweeper;
 class ConservativeRoots;
 class GCDeferralContext;
 class EdenGCActivityCallback;
+class EdenSizeController;
+class EphemeronTable;
 class FullGCActivityCallback;
+class GCTelemetry;
+class HeapFootprintController;
 class GCActivityCallback;
 class GCAwareJITStubRoutine;
 class Heap;
@@ -137,11 +144,16 @@ public:
     void writeBarrier(const JSCell* from, JSCell* to);
     
     void writeBarrierWithoutFence(const JSCell* from);
+
+    // Barrier for a store of "to" into element "index" of the object "from". For large arrays this
+    // dirties a card instead of remembering the whole object; see ArrayCardTable.
+    void writeBarrierForElement(const JSCell* from, unsigned index, JSValue to);
     
     void mutatorFence();
     
     // Take this if you know that from->cellState() < barrierThreshold.
     JS_EXPORT_PRIVATE void writeBarrierSlowPath(const JSCell* from);
+    JS_EXPORT_PRIVATE void writeBarrierForElementSlowPath(const JSCell* from, unsigned index);
 
     Heap(VM&, HeapType);
     ~Heap();
@@ -160,6 +172,10 @@ public:
     JS_EXPORT_PRIVATE void setGarbageCollectionTimerEnabled(bool);
 
     JS_EXPORT_PRIVATE IncrementalSweeper& sweeper();
+    ConcurrentSweeper& concurrentSweeper() { return *m_concurrentSweeper; }
+
+    GCTelemetry& gcTelemetry() { return *m_gcTelemetry; }
+    AllocationSiteProfiler* allocationSiteProfiler() { return m_allocationSiteProfiler.get(); }
 
     void addObserver(HeapObserver* observer) { m_observers.append(observer); }
     void removeObserver(HeapObserver* observer) { m_observers.removeFirst(observer); }
@@ -211,6 +227,11 @@ public:
     JS_EXPORT_PRIVATE void collectNow(Synchronousness, GCRequest = GCRequest());
     
     JS_EXPORT_PRIVATE void collectNowFullIfNotDoneRecently(Synchronousness);
+
+    // Uses time in which the embedder has nothing else for the mutator to do. This helps any
+    // collection in progress, starts one if it is due soon and should finish within the budget,
+    // and then sweeps. It returns by the end of the budget, or earlier if it runs out of work.
+    JS_EXPORT_PRIVATE void performIdleWork(Seconds budget);
     
     void collectIfNecessaryOrDefer(GCDeferralContext* = nullptr);
 
@@ -384,6 +405,8 @@ public:
     uint64_t phaseVersion() const { return m_phaseVersion; }
     
     JS_EXPORT_PRIVATE void addMarkingConstraint(std::unique_ptr<MarkingConstraint>);
+    MarkingConstraintSet& constraintSet() { return *m_constraintSet; }
+    EphemeronTable& ephemeronTable() { return *m_ephemeronTable; }
     
     size_t numOpaqueRoots() const { return m_opaqueRoots.size(); }
 
@@ -511,6 +534,8 @@ private:
     typedef uint64_t Ticket;
     Ticket requestCollection(GCRequest);
     void waitForCollection(Ticket);
+    // Returns whether all requested collections were served by the deadline.
+    bool waitForCollectionsUntil(MonotonicTime deadline);
     
     void suspendCompilerThreads();
     void willStartCollection();
@@ -667,6 +692,13 @@ private:
     RefPtr<FullGCActivityCallback> m_fullActivityCallback;
     RefPtr<GCActivityCallback> m_edenActivityCallback;
     Ref<IncrementalSweeper> m_sweeper;
+    std::unique_ptr<ConcurrentSweeper> m_concurrentSweeper;
+    std::unique_ptr<GCTelemetry> m_gcTelemetry;
+    std::unique_ptr<ArrayCardTable> m_arrayCardTable;
+    std::unique_ptr<HeapFootprintController> m_footprintController;
+    std::unique_ptr<EdenSizeController> m_edenSizeController;
+    std::unique_ptr<EphemeronTable> m_ephemeronTable;
+    std::unique_ptr<AllocationSiteProfiler> m_allocationSiteProfiler;
     Ref<StopIfNecessaryTimer> m_stopIfNecessaryTimer;
 
     Vector<HeapObserver*> m_observers;
@@ -691,6 +723,7 @@ private:
     std::unique_ptr<MarkStackArray> m_sharedMutatorMarkStack;
     unsigned m_numberOfActiveParallelMarkers { 0 };
     unsigned m_numberOfWaitingParallelMarkers { 0 };
+    Atomic<unsigned> m_numberOfStealableMarkStackSegments { 0 };
 
     ConcurrentPtrHashSet m_opaqueRoots;
     static constexpr size_t s_blockFragmentLength = 32;
@@ -47,8 +47,9 @@ struct DefaultDestroyFunc {
     }
 };
 
-HeapCellType::HeapCellType(CellAttributes attributes)
+HeapCellType::HeapCellType(CellAttributes attributes, bool hasThreadSafeDestructor)
     : m_attributes(attributes)
+    , m_hasThreadSafeDestructor(hasThreadSafeDestructor)
 {
 }
 
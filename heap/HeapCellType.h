@@ -33,11 +33,15 @@ class HeapCellType {
     WTF_MAKE_NONCOPYABLE(HeapCellType);
     WTF_MAKE_FAST_ALLOCATED;
 public:
-    JS_EXPORT_PRIVATE HeapCellType(CellAttributes);
+    JS_EXPORT_PRIVATE HeapCellType(CellAttributes, bool hasThreadSafeDestructor = false);
     JS_EXPORT_PRIVATE virtual ~HeapCellType();
 
     const CellAttributes& attributes() const { return m_attributes; }
 
+    // If this is true, destroy() may be called on a heap helper thread while the mutator is running.
+    // See Options::useConcurrentDestruction().
+    bool hasThreadSafeDestructor() const { return m_hasThreadSafeDestructor; }
+
     // The purpose of overriding this is to specialize the sweep for your destructors. This won't
     // be called for no-destructor blocks. This must call MarkedBlock::finishSweepKnowingSubspace.
     virtual void finishSweep(MarkedBlock::Handle&, FreeList*);
@@ -47,6 +51,7 @@ public:
 
 private:
     CellAttributes m_attributes;
+    bool m_hasThreadSafeDestructor;
 };
 
 } // namespace JSC
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "HeapFootprintController.h"
+
+#include "Options.h"
+#include <stdio.h>
+#include <wtf/DataLog.h>
+#include <wtf/text/StringConcatenate.h>
+
+#if OS(DARWIN)
+#include <wtf/spi/darwin/ProcessMemoryFootprint.h>
+#elif OS(LINUX)
+#include <wtf/linux/ProcessMemoryFootprint.h>
+#endif
+
+namespace JSC {
+
+namespace {
+
+constexpr unsigned cachedCallsBetweenSamples = 100;
+constexpr Seconds minimumTimeBetweenSamples = 10_ms;
+
+#if OS(LINUX)
+// Returns the cgroup v2 directory of this process, e.g. /sys/fs/cgroup/system.slice/foo.service.
+CString cgroupDirectory()
+{
+    FILE* file = fopen("/proc/self/cgroup", "r");
+    if (!file)
+        return CString();
+
+    // On the unified hierarchy, /proc/self/cgroup has a single "0::<path>" line.
+    char line[4096];
+    CString result;
+    while (fgets(line, sizeof(line), file)) {
+        if (strncmp(line, "0::", 3))
+            continue;
+        char* path = line + 3;
+        path[strcspn(path, "\n")] = 0;
+        result = makeString("/sys/fs/cgroup", strcmp(path, "/") ? path : "").utf8();
+        break;
+    }
+    fclose(file);
+    return result;
+}
+
+// Reads a cgroup interface file holding one number. Returns 0 if the file is missing or holds "max".
+size_t readCGroupValue(const CString& directory, const char* name)
+{
+    CString path = makeString(directory.data(), '/', name).utf8();
+    FILE* file = fopen(path.data(), "r");
+    if (!file)
+        return 0;
+    unsigned long long value = 0;
+    if (fscanf(file, "%llu", &value) != 1)
+        value = 0;
+    fclose(file);
+    return static_cast<size_t>(value);
+}
+#endif
+
+} // anonymous namespace
+
+HeapFootprintController::HeapFootprintController(size_t minimumEdenBudget)
+    : m_minimumEdenBudget(minimumEdenBudget)
+{
+    m_limit = Options::heapFootprintLimit();
+#if OS(LINUX)
+    if (!m_limit && Options::useCGroupMemoryLimit()) {
+        m_cgroupPath = cgroupDirectory();
+        if (!m_cgroupPath.isNull()) {
+            m_limit = readCGroupValue(m_cgroupPath, "memory.max");
+            m_useCGroup = !!m_limit;
+        }
+    }
+#endif
+    if (!m_limit)
+        return;
+
+    m_target = static_cast<size_t>(m_limit * Options::heapFootprintTargetRatio());
+    dataLogLnIf(Options::logGC(), "Heap footprint limit: ", m_limit / KB, "kb", m_useCGroup ? " (cgroup)" : "", ", target: ", m_target / KB, "kb");
+}
+
+size_t HeapFootprintController::readFootprint()
+{
+#if OS(LINUX)
+    if (m_useCGroup)
+        return readCGroupValue(m_cgroupPath, "memory.current");
+#endif
+#if OS(DARWIN) || OS(LINUX)
+    return ProcessMemoryFootprint::now().current;
+#else
+    return 0;
+#endif
+}
+
+size_t HeapFootprintController::sampleFootprint()
+{
+    m_lastFootprint = readFootprint();
+    m_lastSampleTime = MonotonicTime::now();
+    m_cachedCallCount = 0;
+    return m_lastFootprint;
+}
+
+bool HeapFootprintController::isOverTarget(SampleMode mode)
+{
+    if (!isEnabled())
+        return false;
+    if (mode == SampleMode::Direct)
+        sampleFootprint();
+    else if (++m_cachedCallCount >= cachedCallsBetweenSamples) {
+        if (MonotonicTime::now() - m_lastSampleTime >= minimumTimeBetweenSamples)
+            sampleFootprint();
+        else
+            m_cachedCallCount = 0;
+    }
+    return m_lastFootprint > m_target;
+}
+
+size_t HeapFootprintController::edenBudget(size_t proposedBudget) const
+{
+    if (!isEnabled())
+        return proposedBudget;
+    // Allocating the headroom would bring the footprint up to the target.
+    size_t headroom = m_target > m_lastFootprint ? m_target - m_lastFootprint : 0;
+    return std::min(proposedBudget, std::max(headroom, m_minimumEdenBudget));
+}
+
+} // namespace JSC
@@ -0,0 +1,80 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include <wtf/FastMalloc.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+// Steers heap growth towards a memory footprint limit. The limit either comes from the
+// heapFootprintLimit option or, with useCGroupMemoryLimit, from the cgroup v2 memory.max of the
+// process. The footprint that is compared against it is the cgroup's memory.current when the
+// limit came from the cgroup, and the process footprint otherwise.
+//
+// Heap consults the controller after every collection to cap the Eden budget at the remaining
+// headroom, and while allocating to collect early once the footprint crosses the target. The
+// IncrementalSweeper sweeps eagerly while the footprint is over the target.
+class HeapFootprintController {
+    WTF_MAKE_NONCOPYABLE(HeapFootprintController);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    // The Eden budget never drops below minimumEdenBudget: when most of the footprint is not in the
+    // JS heap, collecting constantly would not help.
+    explicit HeapFootprintController(size_t minimumEdenBudget);
+
+    bool isEnabled() const { return !!m_limit; }
+    size_t limit() const { return m_limit; }
+    size_t target() const { return m_target; }
+
+    // Reads the current footprint. Sampling reads from the file system for cgroups, so
+    // isOverTarget(Cached) only resamples every so often.
+    size_t sampleFootprint();
+    size_t lastFootprint() const { return m_lastFootprint; }
+
+    enum class SampleMode : uint8_t { Cached, Direct };
+    bool isOverTarget(SampleMode = SampleMode::Cached);
+
+    // Returns how many bytes the mutator may allocate before the next collection, given the budget
+    // that the growth factors picked.
+    size_t edenBudget(size_t proposedBudget) const;
+
+private:
+    size_t readFootprint();
+
+    size_t m_limit { 0 };
+    size_t m_target { 0 };
+    size_t m_minimumEdenBudget;
+    size_t m_lastFootprint { 0 };
+    MonotonicTime m_lastSampleTime;
+    unsigned m_cachedCallCount { 0 };
+    bool m_useCGroup { false };
+    CString m_cgroupPath;
+};
+
+} // namespace JSC
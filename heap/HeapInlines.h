@@ -133,6 +133,18 @@ inline void Heap::writeBarrierWithoutFence(const JSCell* from)
         addToRememberedSet(from);
 }
 
+inline void Heap::writeBarrierForElement(const JSCell* from, unsigned index, JSValue to)
+{
+#if ENABLE(WRITE_BARRIER_PROFILING)
+    WriteBarrierCounters::countWriteBarrier();
+#endif
+    if (!to.isCell())
+        return;
+    if (!isWithinThreshold(from->cellState(), barrierThreshold()))
+        return;
+    writeBarrierForElementSlowPath(from, index);
+}
+
 inline void Heap::mutatorFence()
 {
     if (isX86() || UNLIKELY(mutatorShouldBeFenced()))
@@ -34,7 +34,9 @@
 #include "JSCast.h"
 #include "PreventCollectionScope.h"
 #include "VM.h"
+#include <limits>
 #include <wtf/HexNumber.h>
+#include <wtf/text/CString.h>
 #include <wtf/text/StringBuilder.h>
 
 namespace JSC {
@@ -266,12 +268,45 @@ bool HeapSnapshotBuilder::previousSnapshotHasNodeForCell(JSCell* cell, NodeIdent
 //
 //      <rootReasonIndex>
 //       - index into the "labels" list.
+//
+// Heap Snapshot Binary Format:
+//
+//   The binary format carries the same information as the JSON format, but can be written
+//   without holding any string table until the end. It starts with the 8 byte magic "JSCHEAP2"
+//   and one byte of snapshot type (0 = Inspector, 1 = GCDebugging), followed by records. Every
+//   record starts with a one byte tag, and every number is unsigned LEB128:
+//
+//     0 End
+//     1 ClassName  <index>, <byteLength>, <UTF-8 bytes>
+//     2 Label      <index>, <byteLength>, <UTF-8 bytes>
+//     3 EdgeName   <index>, <byteLength>, <UTF-8 bytes>
+//     4 Node       <nodeId>, <sizeInBytes>, <nodeClassNameIndex>, <flags>, [<labelIndex>, <cellAddress>, <wrappedAddress>]
+//     5 Edge       <fromNodeIdDelta>, <toNodeId>, <edgeTypeIndex>, <edgeExtraData>
+//     6 Root       <nodeId>, <rootReasonIndex>, <reachabilityReasonIndex>
+//
+//   Strings are defined by a ClassName, Label or EdgeName record before the first record that
+//   refers to them. The <root> node is implicit and has class name index 0. Edges appear after
+//   all nodes, sorted by from node, and <fromNodeIdDelta> is relative to the previous edge's
+//   from node (or to 0 for the first edge). The bracketed Node fields and Root records are only
+//   present in GCDebugging snapshots.
 
 enum class NodeFlags {
     Internal      = 1 << 0,
     ObjectSubtype = 1 << 1,
 };
 
+enum class BinarySnapshotRecord : uint8_t {
+    End,
+    ClassName,
+    Label,
+    EdgeName,
+    Node,
+    Edge,
+    Root,
+};
+
+static constexpr char binarySnapshotMagic[8] = { 'J', 'S', 'C', 'H', 'E', 'A', 'P', '2' };
+
 static uint8_t edgeTypeToNumber(EdgeType type)
 {
     return static_cast<uint8_t>(type);
@@ -367,11 +402,159 @@ String HeapSnapshotBuilder::descriptionForCell(JSCell *cell) const
     return emptyString();
 }
 
+auto HeapSnapshotBuilder::describeNode(JSCell* cell) const -> NodeDescription
+{
+    VM& vm = m_profiler.vm();
+    NodeDescription result;
+
+    result.className = cell->classInfo(vm)->className;
+    if (cell->isObject() && result.className == JSObject::info()->className) {
+        result.flags |= static_cast<unsigned>(NodeFlags::ObjectSubtype);
+
+        // Skip calculating a class name if this object has a `constructor` own property.
+        // These cases are typically F.prototype objects and we want to treat these as
+        // "Object" in snapshots and not get the name of the prototype's parent.
+        JSObject* object = asObject(cell);
+        if (JSGlobalObject* globalObject = object->globalObject(vm)) {
+            PropertySlot slot(object, PropertySlot::InternalMethodType::VMInquiry, &vm);
+            if (!object->getOwnPropertySlot(object, globalObject, vm.propertyNames->constructor, slot))
+                result.className = JSObject::calculatedClassName(object);
+        }
+    }
+
+    if (cell->isString() || cell->isHeapBigInt())
+        return result;
+
+    Structure* structure = cell->structure(vm);
+    if (!structure || !structure->globalObject())
+        result.flags |= static_cast<unsigned>(NodeFlags::Internal);
+
+    if (m_snapshotType != SnapshotType::GCDebuggingSnapshot)
+        return result;
+
+    auto it = m_cellLabels.find(cell);
+    if (it != m_cellLabels.end())
+        result.label = it->value;
+
+    if (result.label.isEmpty()) {
+        if (auto* object = jsDynamicCast<JSObject*>(vm, cell)) {
+            if (auto* function = jsDynamicCast<JSFunction*>(vm, object))
+                result.label = function->calculatedDisplayName(vm);
+        }
+    }
+
+    String description = descriptionForCell(cell);
+    if (description.length()) {
+        if (result.label.length())
+            result.label.append(' ');
+        result.label.append(description);
+    }
+
+    result.wrappedAddress = m_wrappedObjectPointers.get(cell);
+    return result;
+}
+
+void HeapSnapshotBuilder::prepareEdgesForSerialization(const HashMap<JSCell*, NodeIdentifier>& allowedNodeIdentifiers)
+{
+    // Replace pointers with identifiers.
+    // Remove any edges that we won't need.
+    m_edges.removeAllMatching([&] (HeapSnapshotEdge& edge) {
+        // If the from cell is null, this means a <root> edge.
+        if (!edge.from.cell)
+            edge.from.identifier = 0;
+        else {
+            auto fromLookup = allowedNodeIdentifiers.find(edge.from.cell);
+            if (fromLookup == allowedNodeIdentifiers.end()) {
+                if (m_snapshotType == SnapshotType::GCDebuggingSnapshot)
+                    WTFLogAlways("Failed to find node for from-edge cell %p", edge.from.cell);
+                return true;
+            }
+            edge.from.identifier = fromLookup->value;
+        }
+
+        if (!edge.to.cell)
+            edge.to.identifier = 0;
+        else {
+            auto toLookup = allowedNodeIdentifiers.find(edge.to.cell);
+            if (toLookup == allowedNodeIdentifiers.end()) {
+                if (m_snapshotType == SnapshotType::GCDebuggingSnapshot)
+                    WTFLogAlways("Failed to find node for to-edge cell %p", edge.to.cell);
+                return true;
+            }
+            edge.to.identifier = toLookup->value;
+        }
+
+        return false;
+    });
+
+    m_edges.shrinkToFit();
+
+    // Sort edges based on from identifier.
+    std::sort(m_edges.begin(), m_edges.end(), [&] (const HeapSnapshotEdge& a, const HeapSnapshotEdge& b) {
+        return a.from.identifier < b.from.identifier;
+    });
+}
+
 String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowNodeCallback)
+{
+    StringBuilder json;
+    writeJSON(json, nullptr, allowNodeCallback);
+    return json.toString();
+}
+
+void HeapSnapshotBuilder::write(HeapSnapshotFormat format, const HeapSnapshotSink& sink, Function<bool (const HeapSnapshotNode&)> allowNodeCallback)
+{
+    if (!allowNodeCallback)
+        allowNodeCallback = [] (const HeapSnapshotNode&) { return true; };
+
+    switch (format) {
+    case HeapSnapshotFormat::JSON: {
+        StringBuilder json;
+        writeJSON(json, [&] (StringBuilder& json) {
+            CString utf8 = json.toString().utf8();
+            sink(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length());
+            json.clear();
+        }, allowNodeCallback);
+        return;
+    }
+    case HeapSnapshotFormat::Binary:
+        writeBinary(sink, allowNodeCallback);
+        return;
+    }
+    RELEASE_ASSERT_NOT_REACHED();
+}
+
+bool HeapSnapshotBuilder::writeToFile(HeapSnapshotFormat format, FileSystem::PlatformFileHandle handle)
+{
+    bool success = true;
+    write(format, [&] (const uint8_t* data, size_t length) {
+        while (success && length) {
+            int chunkLength = static_cast<int>(std::min<size_t>(length, std::numeric_limits<int>::max()));
+            int bytesWritten = FileSystem::writeToFile(handle, reinterpret_cast<const char*>(data), chunkLength);
+            if (bytesWritten <= 0) {
+                success = false;
+                return;
+            }
+            data += bytesWritten;
+            length -= bytesWritten;
+        }
+    });
+    return success;
+}
+
+void HeapSnapshotBuilder::writeJSON(StringBuilder& json, const Function<void(StringBuilder&)>& flush, const Function<bool (const HeapSnapshotNode&)>& allowNodeCallback)
 {
     VM& vm = m_profiler.vm();
     DeferGCForAWhile deferGC(vm.heap);
 
+    // When streaming, hand the output to the sink whenever it gets big, but only in between
+    // complete values so that every chunk is valid UTF-8.
+    static constexpr unsigned flushThreshold = 64 * KB;
+    auto flushIfNeeded = [&] {
+        if (flush && json.length() >= flushThreshold)
+            flush(json);
+    };
+
     // Build a node to identifier map of allowed nodes to use when serializing edges.
     HashMap<JSCell*, NodeIdentifier> allowedNodeIdentifiers;
 
@@ -389,73 +572,26 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
     HashMap<UniquedStringImpl*, unsigned> edgeNameIndexes;
     unsigned nextEdgeNameIndex = 0;
 
-    StringBuilder json;
-
     auto appendNodeJSON = [&] (const HeapSnapshotNode& node) {
         // Let the client decide if they want to allow or disallow certain nodes.
         if (!allowNodeCallback(node))
             return;
 
-        unsigned flags = 0;
-
         allowedNodeIdentifiers.set(node.cell, node.identifier);
 
-        String className = node.cell->classInfo(vm)->className;
-        if (node.cell->isObject() && className == JSObject::info()->className) {
-            flags |= static_cast<unsigned>(NodeFlags::ObjectSubtype);
-
-            // Skip calculating a class name if this object has a `constructor` own property.
-            // These cases are typically F.prototype objects and we want to treat these as
-            // "Object" in snapshots and not get the name of the prototype's parent.
-            JSObject* object = asObject(node.cell);
-            if (JSGlobalObject* globalObject = object->globalObject(vm)) {
-                PropertySlot slot(object, PropertySlot::InternalMethodType::VMInquiry, &vm);
-                if (!object->getOwnPropertySlot(object, globalObject, vm.propertyNames->constructor, slot))
-                    className = JSObject::calculatedClassName(object);
-            }
-        }
+        NodeDescription description = describeNode(node.cell);
 
-        auto result = classNameIndexes.add(className, nextClassNameIndex);
+        auto result = classNameIndexes.add(description.className, nextClassNameIndex);
         if (result.isNewEntry)
             nextClassNameIndex++;
         unsigned classNameIndex = result.iterator->value;
 
-        void* wrappedAddress = nullptr;
         unsigned labelIndex = 0;
-        if (!node.cell->isString() && !node.cell->isHeapBigInt()) {
-            Structure* structure = node.cell->structure(vm);
-            if (!structure || !structure->globalObject())
-                flags |= static_cast<unsigned>(NodeFlags::Internal);
-
-            if (m_snapshotType == SnapshotType::GCDebuggingSnapshot) {
-                String nodeLabel;
-                auto it = m_cellLabels.find(node.cell);
-                if (it != m_cellLabels.end())
-                    nodeLabel = it->value;
-
-                if (nodeLabel.isEmpty()) {
-                    if (auto* object = jsDynamicCast<JSObject*>(vm, node.cell)) {
-                        if (auto* function = jsDynamicCast<JSFunction*>(vm, object))
-                            nodeLabel = function->calculatedDisplayName(vm);
-                    }
-                }
-
-                String description = descriptionForCell(node.cell);
-                if (description.length()) {
-                    if (nodeLabel.length())
-                        nodeLabel.append(' ');
-                    nodeLabel.append(description);
-                }
-
-                if (!nodeLabel.isEmpty() && m_snapshotType == SnapshotType::GCDebuggingSnapshot) {
-                    auto result = labelIndexes.add(nodeLabel, nextLabelIndex);
-                    if (result.isNewEntry)
-                        nextLabelIndex++;
-                    labelIndex = result.iterator->value;
-                }
-
-                wrappedAddress = m_wrappedObjectPointers.get(node.cell);
-            }
+        if (!description.label.isEmpty()) {
+            auto result = labelIndexes.add(description.label, nextLabelIndex);
+            if (result.isNewEntry)
+                nextLabelIndex++;
+            labelIndex = result.iterator->value;
         }
 
         // <nodeId>, <sizeInBytes>, <nodeClassNameIndex>, <flags>, [<labelIndex>, <cellEddress>, <wrappedAddress>]
@@ -466,16 +602,17 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
         json.append(',');
         json.appendNumber(classNameIndex);
         json.append(',');
-        json.appendNumber(flags);
+        json.appendNumber(description.flags);
         if (m_snapshotType == SnapshotType::GCDebuggingSnapshot) {
             json.append(',');
             json.appendNumber(labelIndex);
             json.appendLiteral(",\"0x");
             json.append(hex(reinterpret_cast<uintptr_t>(node.cell), Lowercase));
             json.appendLiteral("\",\"0x");
-            json.append(hex(reinterpret_cast<uintptr_t>(wrappedAddress), Lowercase));
+            json.append(hex(reinterpret_cast<uintptr_t>(description.wrappedAddress), Lowercase));
             json.append('"');
         }
+        flushIfNeeded();
     };
 
     bool firstEdge = true;
@@ -509,6 +646,7 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
             json.append('0');
             break;
         }
+        flushIfNeeded();
     };
 
     json.append('{');
@@ -551,49 +689,14 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
             json.append(',');
         firstClassName = false;
         json.appendQuotedJSONString(className);
+        flushIfNeeded();
     }
     orderedClassNames.clear();
     json.append(']');
 
     // Process edges.
-    // Replace pointers with identifiers.
-    // Remove any edges that we won't need.
-    m_edges.removeAllMatching([&] (HeapSnapshotEdge& edge) {
-        // If the from cell is null, this means a <root> edge.
-        if (!edge.from.cell)
-            edge.from.identifier = 0;
-        else {
-            auto fromLookup = allowedNodeIdentifiers.find(edge.from.cell);
-            if (fromLookup == allowedNodeIdentifiers.end()) {
-                if (m_snapshotType == SnapshotType::GCDebuggingSnapshot)
-                    WTFLogAlways("Failed to find node for from-edge cell %p", edge.from.cell);
-                return true;
-            }
-            edge.from.identifier = fromLookup->value;
-        }
-
-        if (!edge.to.cell)
-            edge.to.identifier = 0;
-        else {
-            auto toLookup = allowedNodeIdentifiers.find(edge.to.cell);
-            if (toLookup == allowedNodeIdentifiers.end()) {
-                if (m_snapshotType == SnapshotType::GCDebuggingSnapshot)
-                    WTFLogAlways("Failed to find node for to-edge cell %p", edge.to.cell);
-                return true;
-            }
-            edge.to.identifier = toLookup->value;
-        }
-
-        return false;
-    });
-
+    prepareEdgesForSerialization(allowedNodeIdentifiers);
     allowedNodeIdentifiers.clear();
-    m_edges.shrinkToFit();
-
-    // Sort edges based on from identifier.
-    std::sort(m_edges.begin(), m_edges.end(), [&] (const HeapSnapshotEdge& a, const HeapSnapshotEdge& b) {
-        return a.from.identifier < b.from.identifier;
-    });
 
     // edges
     json.append(',');
@@ -630,6 +733,7 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
             json.append(',');
         firstEdgeName = false;
         json.appendQuotedJSONString(edgeName);
+        flushIfNeeded();
     }
     orderedEdgeNames.clear();
     json.append(']');
@@ -673,6 +777,7 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
             }
             json.append(',');
             json.appendNumber(reachabilityReasonIndex);
+            flushIfNeeded();
         }
 
         json.append(']');
@@ -695,6 +800,7 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
 
             firstLabel = false;
             json.appendQuotedJSONString(label);
+            flushIfNeeded();
         }
         orderedLabels.clear();
 
@@ -702,7 +808,191 @@ String HeapSnapshotBuilder::json(Function<bool (const HeapSnapshotNode&)> allowN
     }
 
     json.append('}');
-    return json.toString();
+    if (flush)
+        flush(json);
+}
+
+namespace {
+
+// Buffers binary snapshot output and hands it to the sink in fixed-size chunks.
+class BinarySnapshotWriter {
+    WTF_MAKE_NONCOPYABLE(BinarySnapshotWriter);
+public:
+    BinarySnapshotWriter(const HeapSnapshotSink& sink)
+        : m_sink(sink)
+    {
+        m_buffer.reserveInitialCapacity(bufferSize);
+    }
+
+    ~BinarySnapshotWriter()
+    {
+        flush();
+    }
+
+    void writeByte(uint8_t byte)
+    {
+        m_buffer.append(byte);
+        if (m_buffer.size() >= bufferSize)
+            flush();
+    }
+
+    void writeBytes(const uint8_t* data, size_t length)
+    {
+        if (m_buffer.size() + length > bufferSize)
+            flush();
+        if (length >= bufferSize) {
+            m_sink(data, length);
+            return;
+        }
+        m_buffer.append(data, length);
+    }
+
+    // Unsigned LEB128, so that the small numbers that dominate snapshots take one or two bytes.
+    void writeNumber(uint64_t value)
+    {
+        do {
+            uint8_t byte = value & 0x7f;
+            value >>= 7;
+            if (value)
+                byte |= 0x80;
+            writeByte(byte);
+        } while (value);
+    }
+
+    void writeString(const String& string)
+    {
+        CString utf8 = string.utf8();
+        writeNumber(utf8.length());
+        writeBytes(reinterpret_cast<const uint8_t*>(utf8.data()), utf8.length());
+    }
+
+    void flush()
+    {
+        if (m_buffer.isEmpty())
+            return;
+        m_sink(m_buffer.data(), m_buffer.size());
+        m_buffer.shrink(0);
+    }
+
+private:
+    static constexpr size_t bufferSize = 64 * KB;
+
+    const HeapSnapshotSink& m_sink;
+    Vector<uint8_t> m_buffer;
+};
+
+} // anonymous namespace
+
+void HeapSnapshotBuilder::writeBinary(const HeapSnapshotSink& sink, const Function<bool (const HeapSnapshotNode&)>& allowNodeCallback)
+{
+    VM& vm = m_profiler.vm();
+    DeferGCForAWhile deferGC(vm.heap);
+
+    BinarySnapshotWriter writer(sink);
+
+    // Strings are defined in the stream the first time they are used, so unlike the JSON format
+    // there is no string table to hold onto until the end.
+    auto internString = [&] (auto& indexes, const auto& key, const String& string, BinarySnapshotRecord record) -> unsigned {
+        auto result = indexes.add(key, indexes.size());
+        if (result.isNewEntry) {
+            writer.writeByte(static_cast<uint8_t>(record));
+            writer.writeNumber(result.iterator->value);
+            writer.writeString(string);
+        }
+        return result.iterator->value;
+    };
+
+    HashMap<JSCell*, NodeIdentifier> allowedNodeIdentifiers;
+    HashMap<String, unsigned> classNameIndexes;
+    HashMap<String, unsigned> labelIndexes;
+    HashMap<UniquedStringImpl*, unsigned> edgeNameIndexes;
+
+    writer.writeBytes(reinterpret_cast<const uint8_t*>(binarySnapshotMagic), sizeof(binarySnapshotMagic));
+    writer.writeByte(static_cast<uint8_t>(m_snapshotType));
+
+    internString(classNameIndexes, "<root>"_s, "<root>"_s, BinarySnapshotRecord::ClassName);
+    internString(labelIndexes, emptyString(), emptyString(), BinarySnapshotRecord::Label);
+
+    for (HeapSnapshot* snapshot = m_profiler.mostRecentSnapshot(); snapshot; snapshot = snapshot->previous()) {
+        for (auto& node : snapshot->m_nodes) {
+            if (!allowNodeCallback(node))
+                continue;
+
+            allowedNodeIdentifiers.set(node.cell, node.identifier);
+
+            NodeDescription description = describeNode(node.cell);
+            unsigned classNameIndex = internString(classNameIndexes, description.className, description.className, BinarySnapshotRecord::ClassName);
+            // Labels are only computed for GCDebugging snapshots, so this is usually a null String,
+            // which cannot be a HashMap key. Like the JSON format, use the empty label for it.
+            unsigned labelIndex = 0;
+            if (!description.label.isEmpty())
+                labelIndex = internString(labelIndexes, description.label, description.label, BinarySnapshotRecord::Label);
+
+            writer.writeByte(static_cast<uint8_t>(BinarySnapshotRecord::Node));
+            writer.writeNumber(node.identifier);
+            writer.writeNumber(node.cell->estimatedSizeInBytes(vm));
+            writer.writeNumber(classNameIndex);
+            writer.writeNumber(description.flags);
+            if (m_snapshotType == SnapshotType::GCDebuggingSnapshot) {
+                writer.writeNumber(labelIndex);
+                writer.writeNumber(reinterpret_cast<uintptr_t>(node.cell));
+                writer.writeNumber(reinterpret_cast<uintptr_t>(description.wrappedAddress));
+            }
+        }
+    }
+
+    prepareEdgesForSerialization(allowedNodeIdentifiers);
+    allowedNodeIdentifiers.clear();
+
+    // Edges are sorted by their from identifier, so we store it as a delta from the previous edge.
+    NodeIdentifier previousFrom = 0;
+    for (auto& edge : m_edges) {
+        uint32_t data = 0;
+        switch (edge.type) {
+        case EdgeType::Property:
+        case EdgeType::Variable:
+            data = internString(edgeNameIndexes, edge.u.name, String(edge.u.name), BinarySnapshotRecord::EdgeName);
+            break;
+        case EdgeType::Index:
+            data = edge.u.index;
+            break;
+        default:
+            break;
+        }
+
+        writer.writeByte(static_cast<uint8_t>(BinarySnapshotRecord::Edge));
+        writer.writeNumber(edge.from.identifier - previousFrom);
+        writer.writeNumber(edge.to.identifier);
+        writer.writeNumber(edgeTypeToNumber(edge.type));
+        writer.writeNumber(data);
+        previousFrom = edge.from.identifier;
+    }
+
+    if (m_snapshotType == SnapshotType::GCDebuggingSnapshot) {
+        HeapSnapshot* snapshot = m_profiler.mostRecentSnapshot();
+        for (auto it : m_rootData) {
+            auto snapshotNode = snapshot->nodeForCell(it.key);
+            if (!snapshotNode) {
+                WTFLogAlways("Failed to find snapshot node for cell %p", it.key);
+                continue;
+            }
+
+            String rootName = rootTypeToString(it.value.markReason);
+            unsigned labelIndex = internString(labelIndexes, rootName, rootName, BinarySnapshotRecord::Label);
+            unsigned reachabilityReasonIndex = 0;
+            if (it.value.reachabilityFromOpaqueRootReasons) {
+                String reason = it.value.reachabilityFromOpaqueRootReasons;
+                reachabilityReasonIndex = internString(labelIndexes, reason, reason, BinarySnapshotRecord::Label);
+            }
+
+            writer.writeByte(static_cast<uint8_t>(BinarySnapshotRecord::Root));
+            writer.writeNumber(snapshotNode.value().identifier);
+            writer.writeNumber(labelIndex);
+            writer.writeNumber(reachabilityReasonIndex);
+        }
+    }
+
+    writer.writeByte(static_cast<uint8_t>(BinarySnapshotRecord::End));
 }
 
 } // namespace JSC
@@ -27,6 +27,8 @@
 
 #include "HeapAnalyzer.h"
 #include <functional>
+#include <wtf/FileSystem.h>
+#include <wtf/Function.h>
 #include <wtf/HashMap.h>
 #include <wtf/HashSet.h>
 #include <wtf/Lock.h>
@@ -41,6 +43,14 @@ class JSCell;
 
 typedef unsigned NodeIdentifier;
 
+enum class HeapSnapshotFormat : uint8_t {
+    JSON,
+    Binary, // See HeapSnapshotBuilder.cpp for a description of the format.
+};
+
+// Receives a serialized snapshot one chunk at a time, in order.
+using HeapSnapshotSink = Function<void(const uint8_t* data, size_t length)>;
+
 struct HeapSnapshotNode {
     HeapSnapshotNode(JSCell* cell, unsigned identifier)
         : cell(cell)
@@ -131,6 +141,11 @@ public:
     String json();
     String json(Function<bool (const HeapSnapshotNode&)> allowNodeCallback);
 
+    // Like json(), but the serialized snapshot is handed to the sink in bounded chunks as it is
+    // produced, so it never has to be held in memory all at once.
+    void write(HeapSnapshotFormat, const HeapSnapshotSink&, Function<bool (const HeapSnapshotNode&)> allowNodeCallback = nullptr);
+    bool writeToFile(HeapSnapshotFormat, FileSystem::PlatformFileHandle);
+
 private:
     static NodeIdentifier nextAvailableObjectIdentifier;
     static NodeIdentifier getNextObjectIdentifier();
@@ -140,6 +155,17 @@ private:
     bool previousSnapshotHasNodeForCell(JSCell*, NodeIdentifier&);
     
     String descriptionForCell(JSCell*) const;
+
+    struct NodeDescription {
+        String className;
+        String label;
+        void* wrappedAddress { nullptr };
+        unsigned flags { 0 };
+    };
+    NodeDescription describeNode(JSCell*) const;
+    void prepareEdgesForSerialization(const HashMap<JSCell*, NodeIdentifier>& allowedNodeIdentifiers);
+    void writeJSON(StringBuilder&, const Function<void(StringBuilder&)>& flush, const Function<bool (const HeapSnapshotNode&)>& allowNodeCallback);
+    void writeBinary(const HeapSnapshotSink&, const Function<bool (const HeapSnapshotNode&)>& allowNodeCallback);
     
     struct RootData {
         const char* reachabilityFromOpaqueRootReasons { nullptr };
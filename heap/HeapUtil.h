@@ -49,7 +49,7 @@ public:
         Heap& heap, HeapVersion markingVersion, HeapVersion newlyAllocatedVersion, TinyBloomFilter filter,
         void* passedPointer, const Func& func)
     {
-        const HashSet<MarkedBlock*>& set = heap.objectSpace().blocks().set();
+        const MarkedBlockSet& blocks = heap.objectSpace().blocks();
         
         ASSERT(heap.objectSpace().isMarking());
         static constexpr bool isMarking = true;
@@ -86,8 +86,7 @@ public:
             // We may be interested in the last cell of the previous MarkedBlock.
             char* previousPointer = bitwise_cast<char*>(bitwise_cast<uintptr_t>(pointer) - sizeof(IndexingHeader) - 1);
             MarkedBlock* previousCandidate = MarkedBlock::blockFor(previousPointer);
-            if (!filter.ruleOut(bitwise_cast<Bits>(previousCandidate))
-                && set.contains(previousCandidate)
+            if (blocks.contains(previousCandidate, filter)
                 && mayHaveIndexingHeader(previousCandidate->handle().cellKind())) {
                 previousPointer = static_cast<char*>(previousCandidate->handle().cellAlign(previousPointer));
                 if (previousCandidate->handle().isLiveCell(markingVersion, newlyAllocatedVersion, isMarking, previousPointer))
@@ -95,12 +94,7 @@ public:
             }
         }
     
-        if (filter.ruleOut(bitwise_cast<Bits>(candidate))) {
-            ASSERT(!candidate || !set.contains(candidate));
-            return;
-        }
-    
-        if (!set.contains(candidate))
+        if (!blocks.contains(candidate, filter))
             return;
 
         HeapCell::Kind cellKind = candidate->handle().cellKind();
@@ -145,18 +139,11 @@ public:
             return set->contains(pointer);
         }
     
-        const HashSet<MarkedBlock*>& set = heap.objectSpace().blocks().set();
-        
         MarkedBlock* candidate = MarkedBlock::blockFor(pointer);
-        if (filter.ruleOut(bitwise_cast<Bits>(candidate))) {
-            ASSERT(!candidate || !set.contains(candidate));
-            return false;
-        }
-        
         if (!MarkedBlock::isAtomAligned(pointer))
             return false;
         
-        if (!set.contains(candidate))
+        if (!heap.objectSpace().blocks().contains(candidate, filter))
             return false;
         
         if (candidate->handle().cellKind() != HeapCell::JSCell)
@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "HugePageBlockAllocator.h"
+
+#if OS(LINUX)
+#include <sys/mman.h>
+#endif
+
+namespace JSC {
+
+namespace HugePageBlockAllocatorInternal {
+static constexpr bool verbose = false;
+}
+
+HugePageBlockAllocator::HugePageBlockAllocator(AllocateChunkFunction&& allocateChunk, FreeChunkFunction&& freeChunk)
+    : m_allocateChunk(WTFMove(allocateChunk))
+    , m_freeChunk(WTFMove(freeChunk))
+{
+}
+
+HugePageBlockAllocator::~HugePageBlockAllocator()
+{
+    for (auto& chunk : m_chunks.values())
+        m_freeChunk(chunk->base);
+}
+
+void HugePageBlockAllocator::addToBucket(Chunk* chunk)
+{
+    m_chunksByNumberOfFreeBlocks[chunk->numberOfFreeBlocks].push(chunk);
+    m_nonEmptyBuckets.set(chunk->numberOfFreeBlocks);
+}
+
+void HugePageBlockAllocator::removeFromBucket(Chunk* chunk)
+{
+    auto& bucket = m_chunksByNumberOfFreeBlocks[chunk->numberOfFreeBlocks];
+    bucket.remove(chunk);
+    if (bucket.isEmpty())
+        m_nonEmptyBuckets.clear(chunk->numberOfFreeBlocks);
+}
+
+auto HugePageBlockAllocator::tryAllocateChunk() -> Chunk*
+{
+    void* base = m_allocateChunk(chunkSize, chunkSize);
+    if (!base)
+        return nullptr;
+    RELEASE_ASSERT(!(bitwise_cast<uintptr_t>(base) & (chunkSize - 1)));
+
+#if OS(LINUX) && defined(MADV_HUGEPAGE)
+    // This is only advice. If transparent huge pages are disabled, we still get a chunk of normal
+    // pages, which is no worse than what we would have gotten otherwise.
+    madvise(base, chunkSize, MADV_HUGEPAGE);
+#endif
+
+    auto chunk = makeUnique<Chunk>();
+    chunk->base = base;
+    chunk->numberOfFreeBlocks = blocksPerChunk;
+    Chunk* result = chunk.get();
+    m_chunks.add(bitwise_cast<uintptr_t>(base), WTFMove(chunk));
+    addToBucket(result);
+    m_numberOfEmptyChunks++;
+    dataLogLnIf(HugePageBlockAllocatorInternal::verbose, "HugePageBlockAllocator: allocated chunk ", RawPointer(base), ", now have ", m_chunks.size());
+    return result;
+}
+
+void HugePageBlockAllocator::releaseChunk(Chunk* chunk)
+{
+    ASSERT(chunk->numberOfFreeBlocks == blocksPerChunk);
+    dataLogLnIf(HugePageBlockAllocatorInternal::verbose, "HugePageBlockAllocator: releasing chunk ", RawPointer(chunk->base));
+    removeFromBucket(chunk);
+    m_numberOfEmptyChunks--;
+    void* base = chunk->base;
+    m_chunks.remove(bitwise_cast<uintptr_t>(base));
+    m_freeChunk(base);
+}
+
+void* HugePageBlockAllocator::tryAllocateBlock()
+{
+    auto locker = holdLock(m_lock);
+
+    // Allocate from the fullest chunk that has room, so that the emptier chunks get a chance to
+    // become completely empty and be released.
+    Chunk* best = nullptr;
+    size_t numberOfFreeBlocks = m_nonEmptyBuckets.findBit(1, true);
+    if (numberOfFreeBlocks <= blocksPerChunk)
+        best = m_chunksByNumberOfFreeBlocks[numberOfFreeBlocks].head();
+    else {
+        best = tryAllocateChunk();
+        if (!best)
+            return nullptr;
+    }
+
+    size_t index = best->allocatedBlocks.findBit(0, false);
+    ASSERT(index < blocksPerChunk);
+    best->allocatedBlocks.set(index);
+    removeFromBucket(best);
+    if (best->numberOfFreeBlocks-- == blocksPerChunk)
+        m_numberOfEmptyChunks--;
+    addToBucket(best);
+    return static_cast<char*>(best->base) + index * MarkedBlock::blockSize;
+}
+
+bool HugePageBlockAllocator::freeBlock(void* block)
+{
+    uintptr_t base = bitwise_cast<uintptr_t>(block) & ~(chunkSize - 1);
+
+    auto locker = holdLock(m_lock);
+    auto iter = m_chunks.find(base);
+    if (iter == m_chunks.end())
+        return false;
+    Chunk* chunk = iter->value.get();
+
+    size_t index = (bitwise_cast<uintptr_t>(block) - base) / MarkedBlock::blockSize;
+    ASSERT(chunk->allocatedBlocks.get(index));
+    chunk->allocatedBlocks.clear(index);
+    removeFromBucket(chunk);
+    chunk->numberOfFreeBlocks++;
+    addToBucket(chunk);
+    if (chunk->numberOfFreeBlocks == blocksPerChunk) {
+        m_numberOfEmptyChunks++;
+        if (m_numberOfEmptyChunks > 1)
+            releaseChunk(chunk);
+    }
+    return true;
+}
+
+} // namespace JSC
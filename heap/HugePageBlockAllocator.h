@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "MarkedBlock.h"
+#include <array>
+#include <wtf/Bitmap.h>
+#include <wtf/DoublyLinkedList.h>
+#include <wtf/Function.h>
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/StdLibExtras.h>
+
+namespace JSC {
+
+// Carves MarkedBlocks out of chunks the size of a huge page, and asks the OS to back those chunks
+// with transparent huge pages. Marking and sweeping a large heap touch many blocks in no
+// particular order, so this saves a lot of TLB misses.
+//
+// A chunk is only given back once all of its blocks are free, since giving back a single block
+// would split the huge page. To avoid thrashing, we hold on to one empty chunk.
+class HugePageBlockAllocator {
+    WTF_MAKE_NONCOPYABLE(HugePageBlockAllocator);
+    WTF_MAKE_FAST_ALLOCATED;
+public:
+    static constexpr size_t chunkSize = 2 * MB;
+    static constexpr size_t blocksPerChunk = chunkSize / MarkedBlock::blockSize;
+
+    using AllocateChunkFunction = WTF::Function<void*(size_t alignment, size_t size)>;
+    using FreeChunkFunction = WTF::Function<void(void*)>;
+
+    HugePageBlockAllocator(AllocateChunkFunction&&, FreeChunkFunction&&);
+    ~HugePageBlockAllocator();
+
+    void* tryAllocateBlock();
+
+    // Returns false if the block did not come from this allocator.
+    bool freeBlock(void*);
+
+private:
+    struct Chunk : public DoublyLinkedListNode<Chunk> {
+        WTF_MAKE_STRUCT_FAST_ALLOCATED;
+
+        void* base { nullptr };
+        WTF::Bitmap<blocksPerChunk> allocatedBlocks;
+        unsigned numberOfFreeBlocks { 0 };
+        Chunk* m_prev { nullptr };
+        Chunk* m_next { nullptr };
+    };
+
+    Chunk* tryAllocateChunk();
+    void releaseChunk(Chunk*);
+
+    void addToBucket(Chunk*);
+    void removeFromBucket(Chunk*);
+
+    AllocateChunkFunction m_allocateChunk;
+    FreeChunkFunction m_freeChunk;
+
+    Lock m_lock;
+    HashMap<uintptr_t, std::unique_ptr<Chunk>> m_chunks;
+    // Chunks are bucketed by their number of free blocks, so finding the fullest chunk that has
+    // room takes the same time no matter how many chunks there are.
+    std::array<DoublyLinkedList<Chunk>, blocksPerChunk + 1> m_chunksByNumberOfFreeBlocks;
+    WTF::Bitmap<blocksPerChunk + 1> m_nonEmptyBuckets;
+    unsigned m_numberOfEmptyChunks { 0 };
+};
+
+} // namespace JSC
@@ -36,10 +36,11 @@ namespace JSC {
 static constexpr Seconds sweepTimeSlice = 10_ms;
 static constexpr double sweepTimeTotal = .10;
 static constexpr double sweepTimeMultiplier = 1.0 / sweepTimeTotal;
+static constexpr double eagerSweepTimeMultiplier = 1.0 / 0.5;
 
 void IncrementalSweeper::scheduleTimer()
 {
-    setTimeUntilFire(sweepTimeSlice * sweepTimeMultiplier);
+    setTimeUntilFire(sweepTimeSlice * (m_sweepsEagerly ? eagerSweepTimeMultiplier : sweepTimeMultiplier));
 }
 
 IncrementalSweeper::IncrementalSweeper(Heap* heap)
@@ -64,6 +65,22 @@ void IncrementalSweeper::doSweep(VM& vm, MonotonicTime sweepBeginTime)
         return;
     }
 
+    didFinishSweeping();
+}
+
+bool IncrementalSweeper::sweepUntil(VM& vm, MonotonicTime deadline)
+{
+    while (MonotonicTime::now() < deadline) {
+        if (!sweepNextBlock(vm)) {
+            didFinishSweeping();
+            return true;
+        }
+    }
+    return false;
+}
+
+void IncrementalSweeper::didFinishSweeping()
+{
     if (m_shouldFreeFastMallocMemoryAfterSweeping) {
         WTF::releaseFastMallocFreeMemory();
         m_shouldFreeFastMallocMemoryAfterSweeping = false;
@@ -39,17 +39,25 @@ public:
 
     JS_EXPORT_PRIVATE void startSweeping(Heap&);
     void freeFastMallocMemoryAfterSweeping() { m_shouldFreeFastMallocMemoryAfterSweeping = true; }
+    // When set, the sweeper spends half of its time sweeping rather than a tenth, so that free
+    // memory gets back to the allocator and the OS sooner.
+    void setSweepsEagerly(bool sweepsEagerly) { m_sweepsEagerly = sweepsEagerly; }
 
     void doWork(VM&) final;
     void stopSweeping();
 
+    // Sweeps until the deadline. Returns whether there was nothing left to sweep.
+    bool sweepUntil(VM&, MonotonicTime deadline);
+
 private:
     bool sweepNextBlock(VM&);
     void doSweep(VM&, MonotonicTime startTime);
+    void didFinishSweeping();
     void scheduleTimer();
     
     BlockDirectory* m_currentDirectory;
     bool m_shouldFreeFastMallocMemoryAfterSweeping { false };
+    bool m_sweepsEagerly { false };
 };
 
 } // namespace JSC
@@ -25,10 +25,36 @@
 
 #include "config.h"
 #include "IsoAlignedMemoryAllocator.h"
+
+#include "HugePageBlockAllocator.h"
 #include "MarkedBlock.h"
+#include "Options.h"
+#include <mutex>
+#include <wtf/NeverDestroyed.h>
 
 namespace JSC {
 
+#if !ENABLE(MALLOC_HEAP_BREAKDOWN)
+// An IsoSubspace never gives a block's address back while it is alive, so all of them can share one
+// set of chunks without weakening type isolation: a block still only ever holds cells of one type.
+// Sharing matters because there are many IsoSubspaces and most of them only use a few blocks.
+static HugePageBlockAllocator& hugePageBlockAllocator()
+{
+    static LazyNeverDestroyed<HugePageBlockAllocator> allocator;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        allocator.construct(
+            [] (size_t alignment, size_t size) {
+                return tryFastAlignedMalloc(alignment, size);
+            },
+            [] (void* base) {
+                fastAlignedFree(base);
+            });
+    });
+    return allocator.get();
+}
+#endif
+
 IsoAlignedMemoryAllocator::IsoAlignedMemoryAllocator(CString name)
 #if ENABLE(MALLOC_HEAP_BREAKDOWN)
     : m_debugHeap(name.data())
@@ -44,6 +70,8 @@ IsoAlignedMemoryAllocator::~IsoAlignedMemoryAllocator()
         void* block = m_blocks[i];
         if (!m_committed[i])
             WTF::fastCommitAlignedMemory(block, MarkedBlock::blockSize);
+        if (Options::useHugePagesForMarkedBlocks() && hugePageBlockAllocator().freeBlock(block))
+            continue;
         fastAlignedFree(block);
     }
 #endif
@@ -69,7 +97,13 @@ void* IsoAlignedMemoryAllocator::tryAllocateAlignedMemory(size_t alignment, size
         return result;
     }
     
-    void* result = tryFastAlignedMalloc(MarkedBlock::blockSize, MarkedBlock::blockSize);
+    // Blocks that freeAlignedMemory() decommits still split their huge page, but the blocks in use
+    // keep the benefit.
+    void* result;
+    if (Options::useHugePagesForMarkedBlocks())
+        result = hugePageBlockAllocator().tryAllocateBlock();
+    else
+        result = tryFastAlignedMalloc(MarkedBlock::blockSize, MarkedBlock::blockSize);
     if (!result)
         return nullptr;
     unsigned index = m_blocks.size();
@@ -31,8 +31,8 @@
 
 namespace JSC {
 
-IsoHeapCellType::IsoHeapCellType(DestructionMode destructionMode, DestroyFunctionPtr destroyFunction)
-    : HeapCellType(CellAttributes(destructionMode, HeapCell::JSCell))
+IsoHeapCellType::IsoHeapCellType(DestructionMode destructionMode, DestroyFunctionPtr destroyFunction, bool hasThreadSafeDestructor)
+    : HeapCellType(CellAttributes(destructionMode, HeapCell::JSCell), hasThreadSafeDestructor)
     , m_destroy(destroyFunction)
 {
 }
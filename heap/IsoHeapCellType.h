@@ -34,12 +34,12 @@ class IsoHeapCellType final : public HeapCellType {
 public:
     using DestroyFunctionPtr = void (*)(JSCell*);
 
-    JS_EXPORT_PRIVATE IsoHeapCellType(DestructionMode, DestroyFunctionPtr);
+    JS_EXPORT_PRIVATE IsoHeapCellType(DestructionMode, DestroyFunctionPtr, bool hasThreadSafeDestructor = false);
 
     template<typename CellType>
     static std::unique_ptr<IsoHeapCellType> create()
     {
-        return makeUnique<IsoHeapCellType>(CellType::needsDestruction ? NeedsDestruction : DoesNotNeedDestruction, &CellType::destroy);
+        return makeUnique<IsoHeapCellType>(CellType::needsDestruction ? NeedsDestruction : DoesNotNeedDestruction, &CellType::destroy, CellType::hasThreadSafeDestructor);
     }
 
     JS_EXPORT_PRIVATE void finishSweep(MarkedBlock::Handle&, FreeList*) final;
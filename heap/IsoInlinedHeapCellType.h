@@ -34,7 +34,7 @@ template<typename CellType>
 class IsoInlinedHeapCellType final : public HeapCellType {
 public:
     IsoInlinedHeapCellType()
-        : HeapCellType(CellAttributes(CellType::needsDestruction ? NeedsDestruction : DoesNotNeedDestruction, HeapCell::JSCell))
+        : HeapCellType(CellAttributes(CellType::needsDestruction ? NeedsDestruction : DoesNotNeedDestruction, HeapCell::JSCell), CellType::hasThreadSafeDestructor)
     {
     }
 
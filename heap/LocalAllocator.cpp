@@ -27,6 +27,7 @@
 #include "LocalAllocator.h"
 
 #include "AllocatingScope.h"
+#include "AllocationSiteProfiler.h"
 #include "FreeListInlines.h"
 #include "GCDeferralContext.h"
 #include "LocalAllocatorInlines.h"
@@ -109,6 +110,17 @@ void LocalAllocator::stopAllocatingForGood()
     reset();
 }
 
+ALWAYS_INLINE void* LocalAllocator::sampleAllocationIfNecessary(Heap& heap, void* result, size_t bytesAllocated)
+{
+    // We account for a whole free list at a time, so this samples the first cell allocated after
+    // the sampling interval runs out rather than the exact byte, which is fine for a statistical
+    // profile.
+    AllocationSiteProfiler* profiler = heap.allocationSiteProfiler();
+    if (UNLIKELY(profiler) && profiler->didAllocate(bytesAllocated))
+        profiler->recordSample(heap.vm(), static_cast<HeapCell*>(result), m_directory->cellSize());
+    return result;
+}
+
 void* LocalAllocator::allocateSlowCase(Heap& heap, GCDeferralContext* deferralContext, AllocationFailureMode failureMode)
 {
     SuperSamplerScope superSamplerScope(false);
@@ -116,7 +128,8 @@ void* LocalAllocator::allocateSlowCase(Heap& heap, GCDeferralContext* deferralCo
     doTestCollectionsIfNeeded(heap, deferralContext);
 
     ASSERT(!m_directory->markedSpace().isIterating());
-    heap.didAllocate(m_freeList.originalSize());
+    size_t bytesAllocated = m_freeList.originalSize();
+    heap.didAllocate(bytesAllocated);
     
     didConsumeFreeList();
     
@@ -132,12 +145,12 @@ void* LocalAllocator::allocateSlowCase(Heap& heap, GCDeferralContext* deferralCo
     void* result = tryAllocateWithoutCollecting();
     
     if (LIKELY(result != nullptr))
-        return result;
+        return sampleAllocationIfNecessary(heap, result, bytesAllocated);
 
     Subspace* subspace = m_directory->m_subspace;
     if (subspace->isIsoSubspace()) {
         if (void* result = static_cast<IsoSubspace*>(subspace)->tryAllocateFromLowerTier())
-            return result;
+            return sampleAllocationIfNecessary(heap, result, bytesAllocated);
     }
     
     MarkedBlock::Handle* block = m_directory->tryAllocateBlock(heap);
@@ -150,7 +163,7 @@ void* LocalAllocator::allocateSlowCase(Heap& heap, GCDeferralContext* deferralCo
     m_directory->addBlock(block);
     result = allocateIn(block);
     ASSERT(result);
-    return result;
+    return sampleAllocationIfNecessary(heap, result, bytesAllocated);
 }
 
 void LocalAllocator::didConsumeFreeList()
@@ -67,6 +67,7 @@ private:
     void* tryAllocateIn(MarkedBlock::Handle*);
     void* allocateIn(MarkedBlock::Handle*);
     ALWAYS_INLINE void doTestCollectionsIfNeeded(Heap&, GCDeferralContext*);
+    ALWAYS_INLINE void* sampleAllocationIfNecessary(Heap&, void* result, size_t bytesAllocated);
 
     BlockDirectory* m_directory;
     FreeList m_freeList;
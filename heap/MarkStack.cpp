@@ -155,4 +155,38 @@ void MarkStackArray::stealSomeCellsFrom(MarkStackArray& other, size_t idleThread
         append(other.removeLast());
 }
 
+GCArraySegment<const JSCell*>* MarkStackArray::takeFullSegment()
+{
+    if (m_numberOfSegments <= 1)
+        return nullptr;
+
+    validatePrevious();
+
+    // Take the oldest segment. It is the one furthest from the current head, so handing it out
+    // disturbs the locality of our own traversal the least.
+    GCArraySegment<const JSCell*>* segment = m_segments.tail();
+    ASSERT(segment != m_segments.head());
+    ASSERT(segment->m_top == s_segmentCapacity);
+    m_segments.remove(segment);
+    m_numberOfSegments--;
+
+    validatePrevious();
+    return segment;
+}
+
+void MarkStackArray::adoptFullSegment(GCArraySegment<const JSCell*>* segment)
+{
+    ASSERT(segment->m_top == s_segmentCapacity);
+
+    validatePrevious();
+
+    // Keep our partially filled head in front so that append() and removeLast() keep working on it.
+    GCArraySegment<const JSCell*>* myHead = m_segments.removeHead();
+    m_segments.push(segment);
+    m_segments.push(myHead);
+    m_numberOfSegments++;
+
+    validatePrevious();
+}
+
 } // namespace JSC
@@ -39,6 +39,12 @@ public:
     size_t transferTo(MarkStackArray&, size_t limit); // Optimized for when `limit` is small.
     void donateSomeCellsTo(MarkStackArray&);
     void stealSomeCellsFrom(MarkStackArray&, size_t idleThreadCount);
+
+    // These move whole full segments in and out of the array without copying any cells. They are
+    // used to publish work to, and take work from, a MarkStackStealingDeque.
+    size_t numberOfFullSegments() const { return m_numberOfSegments - 1; }
+    GCArraySegment<const JSCell*>* takeFullSegment();
+    void adoptFullSegment(GCArraySegment<const JSCell*>*);
 };
 
 } // namespace JSC
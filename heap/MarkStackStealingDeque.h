@@ -0,0 +1,111 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "GCSegmentedArray.h"
+#include <wtf/Atomics.h>
+#include <wtf/Noncopyable.h>
+
+namespace JSC {
+
+class JSCell;
+
+// A bounded Chase-Lev work-stealing deque of full mark stack segments. The owning SlotVisitor
+// pushes and pops at the bottom without taking any locks, and other SlotVisitors steal from the
+// top. See "Dynamic Circular Work-Stealing Deque" (Chase and Lev, SPAA 2005) and "Correct and
+// Efficient Work-Stealing for Weak Memory Models" (Le et al., PPoPP 2013) for the memory ordering.
+class MarkStackStealingDeque {
+    WTF_MAKE_NONCOPYABLE(MarkStackStealingDeque);
+public:
+    using Segment = GCArraySegment<const JSCell*>;
+
+    static constexpr unsigned capacity = 64;
+    static_assert(!(capacity & (capacity - 1)), "capacity must be a power of two");
+
+    MarkStackStealingDeque() = default;
+
+    // Only the owner may call push() and pop().
+    bool push(Segment* segment)
+    {
+        int64_t bottom = m_bottom.loadRelaxed();
+        int64_t top = m_top.load(std::memory_order_acquire);
+        if (bottom - top >= static_cast<int64_t>(capacity))
+            return false;
+        m_segments[bottom & mask].storeRelaxed(segment);
+        WTF::storeStoreFence();
+        m_bottom.storeRelaxed(bottom + 1);
+        return true;
+    }
+
+    Segment* pop()
+    {
+        int64_t bottom = m_bottom.loadRelaxed() - 1;
+        m_bottom.storeRelaxed(bottom);
+        WTF::storeLoadFence();
+        int64_t top = m_top.loadRelaxed();
+        if (top > bottom) {
+            m_bottom.storeRelaxed(bottom + 1);
+            return nullptr;
+        }
+        Segment* result = m_segments[bottom & mask].loadRelaxed();
+        if (top == bottom) {
+            // This is the last segment, so we are racing with thieves for it.
+            if (!m_top.compareExchangeStrong(top, top + 1))
+                result = nullptr;
+            m_bottom.storeRelaxed(bottom + 1);
+        }
+        return result;
+    }
+
+    // Anyone may call steal(). It can fail spuriously if it loses a race.
+    Segment* steal()
+    {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        WTF::storeLoadFence();
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom)
+            return nullptr;
+        Segment* result = m_segments[top & mask].loadRelaxed();
+        if (!m_top.compareExchangeStrong(top, top + 1))
+            return nullptr;
+        return result;
+    }
+
+    size_t sizeSnapshot() const
+    {
+        int64_t size = m_bottom.loadRelaxed() - m_top.loadRelaxed();
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+private:
+    static constexpr unsigned mask = capacity - 1;
+
+    Atomic<int64_t> m_top { 0 };
+    Atomic<int64_t> m_bottom { 0 };
+    Atomic<Segment*> m_segments[capacity] { };
+};
+
+} // namespace JSC
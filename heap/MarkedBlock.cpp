@@ -27,7 +27,10 @@
 #include "MarkedBlock.h"
 
 #include "AlignedMemoryAllocator.h"
+#include "ConcurrentSweeper.h"
 #include "FreeListInlines.h"
+#include "GCTelemetry.h"
+#include "HeapCellType.h"
 #include "JSCJSValueInlines.h"
 #include "MarkedBlockInlines.h"
 #include "SweepingScope.h"
@@ -387,6 +390,8 @@ void MarkedBlock::Handle::sweep(FreeList* freeList)
     SweepMode sweepMode = freeList ? SweepToFreeList : SweepOnly;
     
     m_directory->setIsUnswept(NoLockingNecessary, this, false);
+
+    heap()->gcTelemetry().didSweepBlock();
     
     m_weakSet.sweep();
     
@@ -406,6 +411,23 @@ void MarkedBlock::Handle::sweep(FreeList* freeList)
         RELEASE_ASSERT_NOT_REACHED();
     }
     
+    if (m_concurrentSweepSlot) {
+        if (Optional<PreSweptFreeList> preSwept = heap()->concurrentSweeper().claim(*this)) {
+            if (sweepMode == SweepToFreeList) {
+                installPreSweptFreeList(*preSwept, freeList);
+                return;
+            }
+            // We only get here for SweepOnly if the block needs destruction, and the helper has
+            // already run its destructors. The IsoCellSets still need to forget the dead cells,
+            // just like they would for a sweep we did ourselves.
+            subspace()->didBeginSweepingToFreeList(this);
+            m_directory->setIsDestructible(NoLockingNecessary, this, false);
+            if (preSwept->isEmpty)
+                m_directory->setIsEmpty(NoLockingNecessary, this, true);
+            return;
+        }
+    }
+    
     if (space()->isMarking())
         blockFooter().m_lock.lock();
     
@@ -471,6 +493,69 @@ bool MarkedBlock::Handle::isFreeListedCell(const void* target) const
     return m_directory->isFreeListedCell(target);
 }
 
+void MarkedBlock::Handle::sweepConcurrently(PreSweptFreeList& result, HeapCellType* destructorCellType)
+{
+    // This is the NotEmpty, SweepToFreeList case of specializedSweep(), except that it must not
+    // change anything the mutator can see. The block's bits and the directory's bits are left for
+    // installPreSweptFreeList() to update. Destroying and zapping dead cells is fine since nobody
+    // looks at them, and a later sweep will skip the cells we zapped.
+    ASSERT(needsDestruction() == !!destructorCellType);
+    ASSERT(!destructorCellType || destructorCellType->hasThreadSafeDestructor());
+    ASSERT(!space()->isMarking());
+
+    MarkedBlock& block = this->block();
+    MarkedBlock::Footer& footer = block.footer();
+    unsigned cellSize = this->cellSize();
+    bool marksAreUseful = marksMode() == MarksNotStale;
+    bool hasNewlyAllocated = newlyAllocatedMode() == HasNewlyAllocated;
+    bool shouldScribble = scribbleMode() == Scribble;
+
+    FreeCell* head = nullptr;
+    size_t count = 0;
+    bool isEmpty = true;
+    uintptr_t secret;
+    cryptographicallyRandomValues(&secret, sizeof(uintptr_t));
+    for (size_t i = 0; i < m_endAtom; i += m_atomsPerCell) {
+        if ((marksAreUseful && footer.m_marks.get(i))
+            || (hasNewlyAllocated && footer.m_newlyAllocated.get(i))) {
+            isEmpty = false;
+            continue;
+        }
+
+        if (destructorCellType) {
+            JSCell* jsCell = reinterpret_cast_ptr<JSCell*>(&block.atoms()[i]);
+            if (!jsCell->isZapped()) {
+                destructorCellType->destroy(vm(), jsCell);
+                jsCell->zap(HeapCell::Destruction);
+            }
+        }
+
+        FreeCell* freeCell = reinterpret_cast_ptr<FreeCell*>(&block.atoms()[i]);
+        if (shouldScribble)
+            scribble(freeCell, cellSize);
+        freeCell->setNext(head, secret);
+        head = freeCell;
+        ++count;
+    }
+
+    result.head = head;
+    result.secret = secret;
+    result.bytes = count * cellSize;
+    result.hadNewlyAllocated = hasNewlyAllocated;
+    result.isEmpty = isEmpty;
+}
+
+void MarkedBlock::Handle::installPreSweptFreeList(const PreSweptFreeList& preSwept, FreeList* freeList)
+{
+    ASSERT(!space()->isMarking());
+    subspace()->didBeginSweepingToFreeList(this);
+    m_directory->setIsDestructible(NoLockingNecessary, this, false);
+    if (preSwept.hadNewlyAllocated)
+        blockFooter().m_newlyAllocatedVersion = MarkedSpace::nullVersion;
+    freeList->initializeList(preSwept.head, preSwept.secret, preSwept.bytes);
+    setIsFreeListed();
+}
+
 } // namespace JSC
 
 namespace WTF {
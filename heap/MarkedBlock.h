@@ -37,13 +37,16 @@
 namespace JSC {
 
 class AlignedMemoryAllocator;    
+class ConcurrentSweeper;
 class FreeList;
 class Heap;
+class HeapCellType;
 class JSCell;
 class BlockDirectory;
 class MarkedSpace;
 class SlotVisitor;
 class Subspace;
+struct PreSweptFreeList;
 
 typedef uint32_t HeapVersion;
 
@@ -106,6 +109,7 @@ public:
     class Handle {
         WTF_MAKE_NONCOPYABLE(Handle);
         WTF_MAKE_STRUCT_FAST_ALLOCATED_WITH_HEAP_IDENTIFIER(MarkedBlockHandle);
+        friend class ConcurrentSweeper;
         friend class LLIntOffsetsExtractor;
         friend class MarkedBlock;
         friend struct VerifyMarked;
@@ -196,6 +200,8 @@ public:
         
         unsigned index() const { return m_index; }
         
+        bool hasConcurrentSweepSlot() const { return !!m_concurrentSweepSlot; }
+        
         void removeFromDirectory();
         
         void didAddToDirectory(BlockDirectory*, unsigned index);
@@ -227,12 +233,18 @@ public:
         
         void setIsFreeListed();
         
+        // sweepConcurrently() runs on a heap helper thread. installPreSweptFreeList() runs on the
+        // mutator once it has claimed the result from the ConcurrentSweeper.
+        void sweepConcurrently(PreSweptFreeList&, HeapCellType* destructorCellType);
+        void installPreSweptFreeList(const PreSweptFreeList&, FreeList*);
+        
         unsigned m_atomsPerCell { std::numeric_limits<unsigned>::max() };
         unsigned m_endAtom { std::numeric_limits<unsigned>::max() }; // This is a fuzzy end. Always test for < m_endAtom.
             
         CellAttributes m_attributes;
         bool m_isFreeListed { false };
         unsigned m_index { std::numeric_limits<unsigned>::max() };
+        unsigned m_concurrentSweepSlot { 0 }; // One more than the index of this block's ConcurrentSweeper slot, or zero.
 
         AlignedMemoryAllocator* m_alignedMemoryAllocator { nullptr };
         BlockDirectory* m_directory { nullptr };
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "MarkedBlockBitmapIndex.h"
+
+#include <wtf/OSAllocator.h>
+
+namespace JSC {
+
+MarkedBlockBitmapIndex::~MarkedBlockBitmapIndex()
+{
+    // Walking the top level to find the leaves would touch every one of its pages.
+    for (Leaf* leaf : m_allocatedLeaves)
+        fastFree(leaf);
+    if (m_leaves)
+        OSAllocator::decommitAndRelease(m_leaves, sizeof(Leaf*) * numberOfLeaves);
+}
+
+bool MarkedBlockBitmapIndex::add(MarkedBlock* block)
+{
+    uintptr_t index = bitwise_cast<uintptr_t>(block) >> logBlockSize;
+    if (index >> (logBlocksPerLeaf + logNumberOfLeaves))
+        return false;
+    // The OS hands the top level out zero filled, and only commits the pages we write to. Blocks
+    // cluster in a few leaves, so most of it is never touched.
+    if (!m_leaves)
+        m_leaves = static_cast<Leaf**>(OSAllocator::reserveAndCommit(sizeof(Leaf*) * numberOfLeaves));
+    Leaf*& leaf = m_leaves[index >> logBlocksPerLeaf];
+    if (!leaf) {
+        leaf = static_cast<Leaf*>(fastZeroedMalloc(sizeof(Leaf)));
+        m_allocatedLeaves.append(leaf);
+    }
+    uintptr_t bit = index & (blocksPerLeaf - 1);
+    leaf->words[bit / bitsPerWord] |= static_cast<uint64_t>(1) << (bit % bitsPerWord);
+    return true;
+}
+
+void MarkedBlockBitmapIndex::remove(MarkedBlock* block)
+{
+    uintptr_t index = bitwise_cast<uintptr_t>(block) >> logBlockSize;
+    ASSERT(contains(block));
+    Leaf* leaf = m_leaves[index >> logBlocksPerLeaf];
+    uintptr_t bit = index & (blocksPerLeaf - 1);
+    leaf->words[bit / bitsPerWord] &= ~(static_cast<uint64_t>(1) << (bit % bitsPerWord));
+}
+
+} // namespace JSC
@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "MarkedBlock.h"
+#include <wtf/MathExtras.h>
+#include <wtf/Noncopyable.h>
+#include <wtf/Vector.h>
+
+namespace JSC {
+
+// A two-level bitmap over the address space with one bit per MarkedBlock-sized chunk, set when
+// that chunk is one of our blocks. Conservative scanning uses it to decide whether a candidate
+// pointer points into one of our blocks with three dependent loads and no hashing. A leaf covers
+// 4GB of address space with a 32KB bitmap and is only allocated once a block lands in it. The top
+// level comes straight from the OS, so only the pages holding pointers to leaves are ever committed.
+class MarkedBlockBitmapIndex {
+    WTF_MAKE_NONCOPYABLE(MarkedBlockBitmapIndex);
+public:
+    MarkedBlockBitmapIndex() = default;
+    ~MarkedBlockBitmapIndex();
+
+    // Returns false if the block lies outside of the address range the index covers.
+    bool add(MarkedBlock*);
+    void remove(MarkedBlock*);
+
+    bool contains(const MarkedBlock* block) const
+    {
+        uintptr_t index = bitwise_cast<uintptr_t>(block) >> logBlockSize;
+        if (index >> (logBlocksPerLeaf + logNumberOfLeaves))
+            return false;
+        if (!m_leaves)
+            return false;
+        const Leaf* leaf = m_leaves[index >> logBlocksPerLeaf];
+        if (!leaf)
+            return false;
+        uintptr_t bit = index & (blocksPerLeaf - 1);
+        return leaf->words[bit / bitsPerWord] & (static_cast<uint64_t>(1) << (bit % bitsPerWord));
+    }
+
+private:
+    static constexpr unsigned addressBits = sizeof(void*) == 8 ? 48 : 32;
+    static constexpr unsigned logBlockSize = WTF::getMSBSetConstexpr(MarkedBlock::blockSize);
+    static constexpr unsigned logBlocksPerLeaf = std::min(18u, addressBits - logBlockSize);
+    static constexpr unsigned logNumberOfLeaves = addressBits - logBlockSize - logBlocksPerLeaf;
+    static constexpr size_t blocksPerLeaf = static_cast<size_t>(1) << logBlocksPerLeaf;
+    static constexpr size_t numberOfLeaves = static_cast<size_t>(1) << logNumberOfLeaves;
+    static constexpr unsigned bitsPerWord = 64;
+
+    struct Leaf {
+        uint64_t words[blocksPerLeaf / bitsPerWord];
+    };
+
+    Leaf** m_leaves { nullptr };
+    Vector<Leaf*, 4> m_allocatedLeaves;
+};
+
+} // namespace JSC
@@ -26,6 +26,8 @@
 #pragma once
 
 #include "MarkedBlock.h"
+#include "MarkedBlockBitmapIndex.h"
+#include "Options.h"
 #include "TinyBloomFilter.h"
 #include <wtf/HashSet.h>
 
@@ -41,21 +43,31 @@ public:
     TinyBloomFilter filter() const;
     const HashSet<MarkedBlock*>& set() const;
 
+    // Tells if the candidate is one of our blocks. The filter must be a copy of filter(); it is
+    // only consulted when the bitmap index is not in use.
+    bool contains(MarkedBlock* candidate, TinyBloomFilter) const;
+
 private:
     void recomputeFilter();
 
     TinyBloomFilter m_filter;
     HashSet<MarkedBlock*> m_set;
+    MarkedBlockBitmapIndex m_index;
+    bool m_useIndex { Options::useMarkedBlockBitmapIndex() };
 };
 
 inline void MarkedBlockSet::add(MarkedBlock* block)
 {
     m_filter.add(reinterpret_cast<Bits>(block));
     m_set.add(block);
+    if (m_useIndex && !m_index.add(block))
+        m_useIndex = false;
 }
 
 inline void MarkedBlockSet::remove(MarkedBlock* block)
 {
+    if (m_useIndex)
+        m_index.remove(block);
     unsigned oldCapacity = m_set.capacity();
     m_set.remove(block);
     if (m_set.capacity() != oldCapacity) // Indicates we've removed a lot of blocks.
@@ -80,4 +92,17 @@ inline const HashSet<MarkedBlock*>& MarkedBlockSet::set() const
     return m_set;
 }
 
+inline bool MarkedBlockSet::contains(MarkedBlock* candidate, TinyBloomFilter filter) const
+{
+    if (m_useIndex) {
+        ASSERT(m_index.contains(candidate) == m_set.contains(candidate));
+        return m_index.contains(candidate);
+    }
+    if (filter.ruleOut(bitwise_cast<Bits>(candidate))) {
+        ASSERT(!candidate || !m_set.contains(candidate));
+        return false;
+    }
+    return m_set.contains(candidate);
+}
+
 } // namespace JSC
@@ -300,6 +300,7 @@ void MarkedSpace::reapWeakSets()
 void MarkedSpace::stopAllocating()
 {
     ASSERT(!isIterating());
+    heap().concurrentSweeper().stopSweeping();
     forEachDirectory(
         [&] (BlockDirectory& directory) -> IterationStatus {
             directory.stopAllocating();
@@ -310,6 +311,7 @@ void MarkedSpace::stopAllocating()
 void MarkedSpace::stopAllocatingForGood()
 {
     ASSERT(!isIterating());
+    heap().concurrentSweeper().stopSweeping();
     forEachDirectory(
         [&] (BlockDirectory& directory) -> IterationStatus {
             directory.stopAllocatingForGood();
@@ -49,12 +49,35 @@ MarkingConstraint::~MarkingConstraint()
 void MarkingConstraint::resetStats()
 {
     m_lastVisitCount = 0;
+    auto locker = holdLock(m_lock);
+    m_executionTimeInLastCollection = Seconds();
+}
+
+Seconds MarkingConstraint::executionTimeInLastCollection()
+{
+    auto locker = holdLock(m_lock);
+    return m_executionTimeInLastCollection;
+}
+
+Seconds MarkingConstraint::totalExecutionTime()
+{
+    auto locker = holdLock(m_lock);
+    return m_totalExecutionTime;
+}
+
+void MarkingConstraint::didExecute(Seconds time)
+{
+    auto locker = holdLock(m_lock);
+    m_executionTimeInLastCollection += time;
+    m_totalExecutionTime += time;
 }
 
 void MarkingConstraint::execute(SlotVisitor& visitor)
 {
     VisitCounter visitCounter(visitor);
+    MonotonicTime before = MonotonicTime::now();
     executeImpl(visitor);
+    didExecute(MonotonicTime::now() - before);
     m_lastVisitCount += visitCounter.visitCount();
     if (verboseMarkingConstraint && visitCounter.visitCount())
         dataLog("(", abbreviatedName(), " visited ", visitCounter.visitCount(), " in execute)");
@@ -83,12 +106,16 @@ void MarkingConstraint::prepareToExecute(const AbstractLocker& constraintSolving
 void MarkingConstraint::doParallelWork(SlotVisitor& visitor, SharedTask<void(SlotVisitor&)>& task)
 {
     VisitCounter visitCounter(visitor);
+    MonotonicTime before = MonotonicTime::now();
     task.run(visitor);
+    Seconds time = MonotonicTime::now() - before;
     if (verboseMarkingConstraint && visitCounter.visitCount())
         dataLog("(", abbreviatedName(), " visited ", visitCounter.visitCount(), " in doParallelWork)");
     {
         auto locker = holdLock(m_lock);
         m_lastVisitCount += visitCounter.visitCount();
+        m_executionTimeInLastCollection += time;
+        m_totalExecutionTime += time;
     }
 }
 
@@ -33,6 +33,7 @@
 #include <wtf/Lock.h>
 #include <wtf/Noncopyable.h>
 #include <wtf/SharedTask.h>
+#include <wtf/Seconds.h>
 #include <wtf/text/CString.h>
 
 namespace JSC {
@@ -59,6 +60,11 @@ public:
     void resetStats();
     
     size_t lastVisitCount() const { return m_lastVisitCount; }
+
+    // Time spent executing this constraint, summed across all the threads that ran parts of it.
+    // The first is for the current or last collection, the second for the lifetime of the heap.
+    Seconds executionTimeInLastCollection();
+    Seconds totalExecutionTime();
     
     void execute(SlotVisitor&);
     
@@ -81,10 +87,14 @@ protected:
     
 private:
     friend class MarkingConstraintSet; // So it can set m_index.
+
+    void didExecute(Seconds);
     
     CString m_abbreviatedName;
     CString m_name;
     size_t m_lastVisitCount { 0 };
+    Seconds m_executionTimeInLastCollection;
+    Seconds m_totalExecutionTime;
     unsigned m_index { UINT_MAX };
     ConstraintVolatility m_volatility;
     ConstraintConcurrency m_concurrency;
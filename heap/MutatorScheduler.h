@@ -25,6 +25,7 @@
 
 #pragma once
 
+#include <wtf/Atomics.h>
 #include <wtf/FastMalloc.h>
 #include <wtf/MonotonicTime.h>
 #include <wtf/Noncopyable.h>
@@ -68,8 +69,19 @@ public:
     
     bool shouldStop(); // Call while resumed, to ask if we should stop now.
     bool shouldResume(); // Call while stopped, to ask if we should resume now.
+
+    // Until the idle deadline the embedder has nothing for the mutator to do, so there is no point
+    // in resuming it: schedulers that let the mutator run during collection should keep the world
+    // stopped until then, and collect with all the markers. The mutator sets the deadline while the
+    // collector thread reads it, so it is stored atomically.
+    void setIdleDeadline(MonotonicTime deadline) { m_idleDeadline.storeRelaxed(deadline.secondsSinceEpoch().value()); }
+    bool isIdle(MonotonicTime now) const { return now < idleDeadline(); }
+    MonotonicTime idleDeadline() const { return MonotonicTime::fromRawSeconds(m_idleDeadline.loadRelaxed()); }
     
     virtual void endCollection() = 0;
+
+private:
+    Atomic<double> m_idleDeadline { 0 };
 };
 
 } // namespace JSC
@@ -27,6 +27,7 @@
 #include "SlotVisitor.h"
 
 #include "ConservativeRoots.h"
+#include "EphemeronTable.h"
 #include "GCSegmentedArrayInlines.h"
 #include "HeapAnalyzer.h"
 #include "HeapCellInlines.h"
@@ -402,6 +403,9 @@ ALWAYS_INLINE void SlotVisitor::visitChildren(const JSCell* cell)
         break;
     }
 
+    if (UNLIKELY(m_heap.ephemeronTable().mayHavePendingKeys()))
+        m_heap.ephemeronTable().didVisitKey(cell, *this);
+
     if (UNLIKELY(m_heapAnalyzer)) {
         if (m_isFirstVisit)
             m_heapAnalyzer->analyzeNode(const_cast<JSCell*>(cell));
@@ -451,6 +455,66 @@ void SlotVisitor::donateKnownParallel(MarkStackArray& from, MarkStackArray& to)
     m_heap.m_markingConditionVariable.notifyAll();
 }
 
+static bool shouldUseWorkStealingMarking()
+{
+    return Options::useWorkStealingMarking() && Options::numberOfGCMarkers() > 1;
+}
+
+void SlotVisitor::publishStealableSegments()
+{
+    // Keep one full segment for ourselves so that we do not immediately have to steal it back.
+    bool didPublish = false;
+    while (m_collectorStack.numberOfFullSegments() > 1) {
+        GCArraySegment<const JSCell*>* segment = m_collectorStack.takeFullSegment();
+        if (!m_stealingDeque.push(segment)) {
+            m_collectorStack.adoptFullSegment(segment);
+            break;
+        }
+        m_heap.m_numberOfStealableMarkStackSegments.exchangeAdd(1);
+        didPublish = true;
+    }
+
+    if (!didPublish)
+        return;
+
+    // Like donateKnownParallel(), don't fight over the lock. Waiting markers will notice the
+    // published segments the next time anyone notifies.
+    std::unique_lock<Lock> lock(m_heap.m_markingMutex, std::try_to_lock);
+    if (!lock.owns_lock())
+        return;
+    if (m_heap.m_numberOfWaitingParallelMarkers)
+        m_heap.m_markingConditionVariable.notifyAll();
+}
+
+bool SlotVisitor::takeStealableSegment()
+{
+    GCArraySegment<const JSCell*>* segment = m_stealingDeque.pop();
+    if (!segment) {
+        m_heap.forEachSlotVisitor(
+            [&] (SlotVisitor& victim) {
+                if (segment || &victim == this)
+                    return;
+                segment = victim.m_stealingDeque.steal();
+            });
+    }
+    if (!segment)
+        return false;
+
+    m_heap.m_numberOfStealableMarkStackSegments.exchangeSub(1);
+    m_collectorStack.adoptFullSegment(segment);
+    return true;
+}
+
+void SlotVisitor::reclaimStealableSegments()
+{
+    // Segments may only sit in our deque while we are draining. Otherwise, termination detection
+    // would have to account for work owned by markers that are not active.
+    while (GCArraySegment<const JSCell*>* segment = m_stealingDeque.pop()) {
+        m_heap.m_numberOfStealableMarkStackSegments.exchangeSub(1);
+        m_collectorStack.adoptFullSegment(segment);
+    }
+}
+
 void SlotVisitor::donateKnownParallel()
 {
     forEachMarkStack(
@@ -495,6 +559,8 @@ NEVER_INLINE void SlotVisitor::drain(MonotonicTime timeout)
     }
     
     auto locker = holdLock(m_rightToRun);
+
+    bool useWorkStealing = shouldUseWorkStealingMarking();
     
     while (!hasElapsed(timeout)) {
         updateMutatorIsStopped(locker);
@@ -512,12 +578,22 @@ NEVER_INLINE void SlotVisitor::drain(MonotonicTime timeout)
                 return IterationStatus::Done;
             });
         propagateExternalMemoryVisitedIfNecessary();
-        if (status == IterationStatus::Continue)
+        if (status == IterationStatus::Continue) {
+            if (useWorkStealing && takeStealableSegment())
+                continue;
             break;
+        }
         
         m_rightToRun.safepoint();
-        donateKnownParallel();
+        if (useWorkStealing) {
+            publishStealableSegments();
+            donateKnownParallel(m_mutatorStack, *m_heap.m_sharedMutatorMarkStack);
+        } else
+            donateKnownParallel();
     }
+
+    if (useWorkStealing)
+        reclaimStealableSegments();
 }
 
 size_t SlotVisitor::performIncrementOfDraining(size_t bytesRequested)
@@ -597,7 +673,8 @@ bool SlotVisitor::hasWork(const AbstractLocker&)
 {
     return !isEmpty()
         || !m_heap.m_sharedCollectorMarkStack->isEmpty()
-        || !m_heap.m_sharedMutatorMarkStack->isEmpty();
+        || !m_heap.m_sharedMutatorMarkStack->isEmpty()
+        || m_heap.m_numberOfStealableMarkStackSegments.load();
 }
 
 NEVER_INLINE SlotVisitor::SharedDrainResult SlotVisitor::drainFromShared(SharedDrainMode sharedDrainMode, MonotonicTime timeout)
@@ -678,6 +755,14 @@ NEVER_INLINE SlotVisitor::SharedDrainResult SlotVisitor::drainFromShared(SharedD
                             m_heap.m_numberOfWaitingParallelMarkers);
                         return IterationStatus::Continue;
                     });
+
+                // With work-stealing marking, the work that woke us up may have been a segment
+                // published by another marker, which that marker may since have taken back.
+                if (isEmpty() && shouldUseWorkStealingMarking() && !takeStealableSegment()) {
+                    m_heap.m_numberOfWaitingParallelMarkers--;
+                    isActive = false;
+                    continue;
+                }
             }
 
             m_heap.m_numberOfActiveParallelMarkers++;
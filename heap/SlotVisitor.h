@@ -28,6 +28,7 @@
 #include "HandleTypes.h"
 #include "IterationStatus.h"
 #include "MarkStack.h"
+#include "MarkStackStealingDeque.h"
 #include "VisitRaceKey.h"
 #include <wtf/Forward.h>
 #include <wtf/MonotonicTime.h>
@@ -225,6 +226,11 @@ private:
     void donateAll(const AbstractLocker&);
 
     bool hasWork(const AbstractLocker&);
+
+    // Used by work-stealing marking (Options::useWorkStealingMarking()).
+    void publishStealableSegments();
+    bool takeStealableSegment();
+    void reclaimStealableSegments();
     bool didReachTermination(const AbstractLocker&);
 
     template<typename Func>
@@ -234,6 +240,7 @@ private:
 
     MarkStackArray m_collectorStack;
     MarkStackArray m_mutatorStack;
+    MarkStackStealingDeque m_stealingDeque;
     
     size_t m_bytesVisited;
     size_t m_visitCount;
@@ -110,7 +110,7 @@ MonotonicTime SpaceTimeMutatorScheduler::timeToStop()
         return MonotonicTime::now();
     case Resumed: {
         Snapshot snapshot(*this);
-        if (!shouldBeResumed(snapshot))
+        if (isIdle(snapshot.now()) || !shouldBeResumed(snapshot))
             return snapshot.now();
         return snapshot.now() - elapsedInPeriod(snapshot) + m_period;
     } }
@@ -127,6 +127,8 @@ MonotonicTime SpaceTimeMutatorScheduler::timeToResume()
         return MonotonicTime::now();
     case Stopped: {
         Snapshot snapshot(*this);
+        if (isIdle(snapshot.now()))
+            return idleDeadline();
         if (shouldBeResumed(snapshot))
             return snapshot.now();
         return snapshot.now() - elapsedInPeriod(snapshot) + m_period * collectorUtilization(snapshot);
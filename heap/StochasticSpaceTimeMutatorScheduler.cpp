@@ -144,6 +144,8 @@ MonotonicTime StochasticSpaceTimeMutatorScheduler::timeToStop()
     case Resumed: {
         // Once we're running, we keep going unless we run out of headroom.
         Snapshot snapshot(*this);
+        if (isIdle(snapshot.now()))
+            return snapshot.now();
         if (mutatorUtilization(snapshot) < Options::epsilonMutatorUtilization())
             return MonotonicTime::now();
         return MonotonicTime::infinity();
@@ -160,7 +162,7 @@ MonotonicTime StochasticSpaceTimeMutatorScheduler::timeToResume()
     case Resumed:
         return MonotonicTime::now();
     case Stopped:
-        return m_plannedResumeTime;
+        return std::max(m_plannedResumeTime, idleDeadline());
     }
     
     RELEASE_ASSERT_NOT_REACHED();
@@ -26,6 +26,7 @@
 #include "config.h"
 #include "InspectorHeapAgent.h"
 
+#include "AllocationSiteProfiler.h"
 #include "HeapProfiler.h"
 #include "HeapSnapshot.h"
 #include "InjectedScript.h"
@@ -259,6 +260,31 @@ Protocol::ErrorStringOr<Ref<Protocol::Runtime::RemoteObject>> InspectorHeapAgent
     return object.releaseNonNull();
 }
 
+Protocol::ErrorStringOr<Ref<JSON::ArrayOf<Protocol::Heap::AllocationSite>>> InspectorHeapAgent::getAllocationSites(Optional<int>&& limit)
+{
+    VM& vm = m_environment.vm();
+    JSLockHolder lock(vm);
+
+    AllocationSiteProfiler* profiler = vm.heap.allocationSiteProfiler();
+    if (!profiler)
+        return makeUnexpected("Allocation sampling is disabled (see the allocationSamplingInterval option)"_s);
+
+    unsigned maxSites = limit && *limit > 0 ? static_cast<unsigned>(*limit) : 100;
+    auto sites = JSON::ArrayOf<Protocol::Heap::AllocationSite>::create();
+    for (auto& site : profiler->topSites(maxSites)) {
+        sites->addItem(Protocol::Heap::AllocationSite::create()
+            .setStack(site.stack)
+            .setAllocatedBytes(site.allocatedBytes)
+            .setRetainedBytes(site.retainedBytes)
+            .setAverageCellSize(site.averageCellSize())
+            .setSamples(site.numberOfSamples)
+            .setLiveSamples(site.numberOfLiveSamples)
+            .setMaxSurvivedCollections(site.maxSurvivedCollections)
+            .release());
+    }
+    return sites;
+}
+
 static Protocol::Heap::GarbageCollection::Type protocolTypeForHeapOperation(CollectionScope scope)
 {
     switch (scope) {
@@ -61,6 +61,7 @@ public:
     Protocol::ErrorStringOr<void> stopTracking() final;
     Protocol::ErrorStringOr<std::tuple<String, RefPtr<Protocol::Debugger::FunctionDetails>, RefPtr<Protocol::Runtime::ObjectPreview>>> getPreview(int heapObjectId) final;
     Protocol::ErrorStringOr<Ref<Protocol::Runtime::RemoteObject>> getRemoteObject(int heapObjectId, const String& objectGroup) final;
+    Protocol::ErrorStringOr<Ref<JSON::ArrayOf<Protocol::Heap::AllocationSite>>> getAllocationSites(Optional<int>&& limit) final;
 
     // JSC::HeapObserver
     void willGarbageCollect() final;
@@ -382,6 +382,7 @@ public:
         : m_allocators(constructFixedSizeArrayWithArguments<RegionAllocator, numberOfRegions>(*this))
 #else
         : m_allocator(*this)
+        , m_coldAllocator(*this)
 #endif
     {
         JITReservation reservation = initializeJITPageReservation();
@@ -409,7 +410,12 @@ public:
                 start += regionSize;
             }
 #else
-            m_allocator.addFreshFreeSpace(reservation.base, reservation.size);
+            // The cold region is carved out of the end of the pool.
+            size_t coldSize = roundDownToMultipleOf(pageSize(), static_cast<size_t>(reservation.size * Options::jitColdCodeRegionFraction()));
+            size_t hotSize = reservation.size - coldSize;
+            m_allocator.addFreshFreeSpace(reservation.base, hotSize);
+            if (coldSize)
+                m_coldAllocator.addFreshFreeSpace(static_cast<char*>(reservation.base) + hotSize, coldSize);
             ASSERT(bytesReserved() == reservation.size); // Since our executable memory is fixed-sized, bytesReserved is never changed after initialization.
 #endif
         }
@@ -425,27 +431,41 @@ public:
     bool isJITPC(void* pc) { return memoryStart() <= pc && pc < memoryEnd(); }
     bool isValid() { return !!m_reservation; }
 
-    RefPtr<ExecutableMemoryHandle> allocate(size_t sizeInBytes)
+    RefPtr<ExecutableMemoryHandle> allocate(size_t sizeInBytes, JITCodePlacement placement)
     {
 #if ENABLE(JUMP_ISLANDS)
         auto locker = holdLock(getLock());
 
+        // With a cold region, cold code fills the regions from the end of the pool and hot code
+        // fills them from the start.
+        bool isCold = placement == JITCodePlacement::Cold && Options::jitColdCodeRegionFraction() > 0;
+
         unsigned start = 0;
         if (Options::useRandomizingExecutableIslandAllocation())
             start = cryptographicallyRandomNumber() % m_allocators.size();
+        else if (isCold)
+            start = m_allocators.size() - 1;
 
         unsigned i = start;
         while (true) {
             RegionAllocator& allocator = m_allocators[i];
             if (RefPtr<ExecutableMemoryHandle> result = allocator.allocate(locker, sizeInBytes))
                 return result;
-            i = (i + 1) % m_allocators.size();
+            if (isCold)
+                i = (i + m_allocators.size() - 1) % m_allocators.size();
+            else
+                i = (i + 1) % m_allocators.size();
             if (i == start)
                 break;
         }
         return nullptr;
 #else
-        return m_allocator.allocate(sizeInBytes);
+        // Either kind of code spills over into the other region rather than failing.
+        Allocator& preferredAllocator = placement == JITCodePlacement::Cold ? m_coldAllocator : m_allocator;
+        Allocator& otherAllocator = placement == JITCodePlacement::Cold ? m_allocator : m_coldAllocator;
+        if (RefPtr<ExecutableMemoryHandle> result = preferredAllocator.allocate(sizeInBytes))
+            return result;
+        return otherAllocator.allocate(sizeInBytes);
 #endif // ENABLE(JUMP_ISLANDS)
     }
 
@@ -484,7 +504,7 @@ public:
             return allocator->isInAllocatedMemory(locker, address);
         return false;
 #else
-        return m_allocator.isInAllocatedMemory(locker, address);
+        return m_allocator.isInAllocatedMemory(locker, address) || m_coldAllocator.isInAllocatedMemory(locker, address);
 #endif
     }
 
@@ -798,6 +818,7 @@ private:
         }
 #else
         function(m_allocator);
+        function(m_coldAllocator);
 #endif // ENABLE(JUMP_ISLANDS)
     }
 
@@ -818,6 +839,7 @@ private:
     RedBlackTree<Islands, void*> m_islandsForJumpSourceLocation;
 #else
     Allocator m_allocator;
+    Allocator m_coldAllocator;
 #endif // ENABLE(JUMP_ISLANDS)
 };
 
@@ -867,14 +889,14 @@ double ExecutableAllocator::memoryPressureMultiplier(size_t addedMemoryUsage)
     return result;
 }
 
-RefPtr<ExecutableMemoryHandle> ExecutableAllocator::allocate(size_t sizeInBytes, JITCompilationEffort effort)
+RefPtr<ExecutableMemoryHandle> ExecutableAllocator::allocate(size_t sizeInBytes, JITCompilationEffort effort, JITCodePlacement placement)
 {
     FixedVMPoolExecutableAllocator* allocator = g_jscConfig.fixedVMPoolExecutableAllocator;
     if (!allocator)
-        return Base::allocate(sizeInBytes, effort);
+        return Base::allocate(sizeInBytes, effort, placement);
     if (Options::logExecutableAllocation()) {
         MetaAllocator::Statistics stats = allocator->currentStatistics();
-        dataLog("Allocating ", sizeInBytes, " bytes of executable memory with ", stats.bytesAllocated, " bytes allocated, ", stats.bytesReserved, " bytes reserved, and ", stats.bytesCommitted, " committed.\n");
+        dataLog("Allocating ", sizeInBytes, " bytes of ", placement == JITCodePlacement::Cold ? "cold" : "hot", " executable memory with ", stats.bytesAllocated, " bytes allocated, ", stats.bytesReserved, " bytes reserved, and ", stats.bytesCommitted, " committed.\n");
     }
 
     if (effort != JITCompilationCanFail && Options::reportMustSucceedExecutableAllocations()) {
@@ -898,7 +920,7 @@ RefPtr<ExecutableMemoryHandle> ExecutableAllocator::allocate(size_t sizeInBytes,
         }
     }
 
-    RefPtr<ExecutableMemoryHandle> result = allocator->allocate(sizeInBytes);
+    RefPtr<ExecutableMemoryHandle> result = allocator->allocate(sizeInBytes, placement);
     if (!result) {
         if (effort != JITCompilationCanFail) {
             dataLog("Ran out of executable memory while allocating ", sizeInBytes, " bytes.\n");
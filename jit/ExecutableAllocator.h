@@ -69,7 +69,7 @@ public:
 
     static void dumpProfile() { }
 
-    RefPtr<ExecutableMemoryHandle> allocate(size_t, JITCompilationEffort) { return nullptr; }
+    RefPtr<ExecutableMemoryHandle> allocate(size_t, JITCompilationEffort, JITCodePlacement = JITCodePlacement::Hot) { return nullptr; }
 
     static void setJITEnabled(bool) { };
     
@@ -170,7 +170,7 @@ public:
     
     JS_EXPORT_PRIVATE static void setJITEnabled(bool);
 
-    RefPtr<ExecutableMemoryHandle> allocate(size_t sizeInBytes, JITCompilationEffort);
+    RefPtr<ExecutableMemoryHandle> allocate(size_t sizeInBytes, JITCompilationEffort, JITCodePlacement = JITCodePlacement::Hot);
 
     bool isValidExecutableMemory(const AbstractLocker&, void* address);
 
@@ -59,6 +59,8 @@ Seconds totalDFGCompileTime;
 Seconds totalFTLCompileTime;
 Seconds totalFTLDFGCompileTime;
 Seconds totalFTLB3CompileTime;
+Seconds totalDFGQueueDelay;
+Seconds totalFTLQueueDelay;
 
 void ctiPatchCallByReturnAddress(ReturnAddressPtr returnAddress, FunctionPtr<CFunctionPtrTag> newCalleeFunction)
 {
@@ -1058,10 +1060,12 @@ HashMap<CString, Seconds> JIT::compileTimeStats()
         result.add("Baseline Compile Time", totalBaselineCompileTime);
 #if ENABLE(DFG_JIT)
         result.add("DFG Compile Time", totalDFGCompileTime);
+        result.add("DFG Queue Delay", totalDFGQueueDelay);
 #if ENABLE(FTL_JIT)
         result.add("FTL Compile Time", totalFTLCompileTime);
         result.add("FTL (DFG) Compile Time", totalFTLDFGCompileTime);
         result.add("FTL (B3) Compile Time", totalFTLB3CompileTime);
+        result.add("FTL Queue Delay", totalFTLQueueDelay);
 #endif // ENABLE(FTL_JIT)
 #endif // ENABLE(DFG_JIT)
     }
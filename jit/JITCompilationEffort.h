@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 namespace JSC {
 
 enum JITCompilationEffort {
@@ -32,4 +34,12 @@ enum JITCompilationEffort {
     JITCompilationMustSucceed
 };
 
+// Cold code is code that runs rarely or churns a lot, like inline cache stubs and OSR exits. When
+// the executable pool has a cold region, it goes there so that it neither fragments nor dilutes
+// the memory holding function bodies.
+enum class JITCodePlacement : uint8_t {
+    Hot,
+    Cold
+};
+
 } // namespace JSC
@@ -58,6 +58,7 @@
 #include "JSWithScope.h"
 #include "LLIntEntrypoint.h"
 #include "ObjectConstructor.h"
+#include "ProfilerLifecycleLog.h"
 #include "PropertyName.h"
 #include "RegExpObject.h"
 #include "Repatch.h"
@@ -1879,6 +1880,7 @@ JSC_DEFINE_JIT_OPERATION(operationOptimize, SlowPathReturnType, (VM* vmPointer,
     
     if (void* dataBuffer = DFG::prepareOSREntry(vm, callFrame, optimizedCodeBlock, bytecodeIndex)) {
         CODEBLOCK_LOG_EVENT(optimizedCodeBlock, "osrEntry", ("at bc#", bytecodeIndex));
+        Profiler::logLifecycleEvent(optimizedCodeBlock, Profiler::LifecycleEventKind::OSREntry, optimizedCodeBlock->jitType(), bytecodeIndex);
         dataLogLnIf(Options::verboseOSR(), "Performing OSR ", codeBlock, " -> ", optimizedCodeBlock);
 
         codeBlock->optimizeSoon();
@@ -120,7 +120,14 @@ private:
         if (m_worklist.m_queue.isEmpty())
             return PollResult::Wait;
         
-        m_myPlans = WTFMove(m_worklist.m_queue);
+        // With a single thread, grab everything. Otherwise take one plan at a time so that a large
+        // compile on one thread does not hold up the plans queued behind it.
+        if (m_worklist.m_threads.size() <= 1)
+            m_myPlans = WTFMove(m_worklist.m_queue);
+        else {
+            m_myPlans.append(WTFMove(m_worklist.m_queue.first()));
+            m_worklist.m_queue.remove(0);
+        }
         m_worklist.m_numAvailableThreads--;
         return PollResult::Work;
     }
@@ -155,7 +162,8 @@ JITWorklist::JITWorklist()
     , m_condition(AutomaticThreadCondition::create())
 {
     LockHolder locker(*m_lock);
-    m_thread = new Thread(locker, *this);
+    for (unsigned i = std::max(Options::numberOfBaselineCompilerThreads(), 1u); i--;)
+        m_threads.append(adoptRef(new Thread(locker, *this)));
 }
 
 JITWorklist::~JITWorklist()
@@ -247,7 +255,10 @@ void JITWorklist::compileLater(CodeBlock* codeBlock, BytecodeIndex loopOSREntryB
         if (m_planned.contains(codeBlock))
             return;
         
-        if (m_numAvailableThreads) {
+        // A very large CodeBlock would stall the main thread for a long time if we compiled it here.
+        // It is better for it to keep running in the LLInt until a thread frees up.
+        bool shouldWaitForThread = codeBlock->instructionsSize() > Options::maximumInstructionsSizeForMainThreadBaselineCompile();
+        if (m_numAvailableThreads || shouldWaitForThread) {
             m_planned.add(codeBlock);
             RefPtr<Plan> plan = adoptRef(new Plan(codeBlock, loopOSREntryBytecodeIndex));
             m_plans.append(plan);
@@ -270,9 +281,9 @@ void JITWorklist::compileLater(CodeBlock* codeBlock, BytecodeIndex loopOSREntryB
     //
     // The single-threaded concurrent JIT has this tendency to convoy everything while at the same
     // time postponing when it happens, which means that the convoy delays are less predictable.
-    // This works around the issue. If the concurrent JIT thread is convoyed, we revert to main
-    // thread compiles. This is probably not as good as if we had multiple JIT threads. Maybe we
-    // can do that someday.
+    // This works around the issue. If the concurrent JIT threads are convoyed, we revert to main
+    // thread compiles. Embedders that would rather avoid long main thread stalls can raise
+    // numberOfBaselineCompilerThreads and lower maximumInstructionsSizeForMainThreadBaselineCompile.
     Plan::compileNow(codeBlock, loopOSREntryBytecodeIndex);
 }
 
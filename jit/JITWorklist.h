@@ -74,7 +74,7 @@ private:
     
     Box<Lock> m_lock;
     Ref<AutomaticThreadCondition> m_condition; // We use One True Condition for everything because that's easier.
-    RefPtr<AutomaticThread> m_thread;
+    Vector<RefPtr<AutomaticThread>> m_threads;
     
     unsigned m_numAvailableThreads { 0 };
 };
@@ -22,6 +22,7 @@
 
 #include "config.h"
 
+#include "AllocationSiteProfiler.h"
 #include "ArrayBuffer.h"
 #include "BigIntConstructor.h"
 #include "BytecodeCacheError.h"
@@ -35,6 +36,7 @@
 #include "Disassembler.h"
 #include "Exception.h"
 #include "ExceptionHelpers.h"
+#include "GCTelemetry.h"
 #include "HeapSnapshotBuilder.h"
 #include "InitializeThreading.h"
 #include "Interpreter.h"
@@ -58,7 +60,9 @@
 #include "LLIntThunks.h"
 #include "ObjectConstructor.h"
 #include "ParserError.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
+#include "ProfilerLifecycleLog.h"
 #include "ReleaseHeapAccessScope.h"
 #include "SamplingProfiler.h"
 #include "SimpleTypedArrayController.h"
@@ -280,6 +284,10 @@ static JSC_DECLARE_HOST_FUNCTION(functionGCAndSweep);
 static JSC_DECLARE_HOST_FUNCTION(functionFullGC);
 static JSC_DECLARE_HOST_FUNCTION(functionEdenGC);
 static JSC_DECLARE_HOST_FUNCTION(functionHeapSize);
+static JSC_DECLARE_HOST_FUNCTION(functionGCTelemetry);
+static JSC_DECLARE_HOST_FUNCTION(functionAllocationSites);
+static JSC_DECLARE_HOST_FUNCTION(functionStructureMemoryStatistics);
+static JSC_DECLARE_HOST_FUNCTION(functionReadCodeBlockLifecycleLog);
 static JSC_DECLARE_HOST_FUNCTION(functionCreateMemoryFootprint);
 static JSC_DECLARE_HOST_FUNCTION(functionResetMemoryPeak);
 static JSC_DECLARE_HOST_FUNCTION(functionAddressOf);
@@ -325,6 +333,7 @@ static JSC_DECLARE_HOST_FUNCTION(functionCheckModuleSyntax);
 static JSC_DECLARE_HOST_FUNCTION(functionPlatformSupportsSamplingProfiler);
 static JSC_DECLARE_HOST_FUNCTION(functionGenerateHeapSnapshot);
 static JSC_DECLARE_HOST_FUNCTION(functionGenerateHeapSnapshotForGCDebugging);
+static JSC_DECLARE_HOST_FUNCTION(functionWriteHeapSnapshot);
 static JSC_DECLARE_HOST_FUNCTION(functionResetSuperSamplerState);
 static JSC_DECLARE_HOST_FUNCTION(functionEnsureArrayStorage);
 #if ENABLE(SAMPLING_PROFILER)
@@ -521,6 +530,10 @@ private:
         addFunction(vm, "fullGC", functionFullGC, 0);
         addFunction(vm, "edenGC", functionEdenGC, 0);
         addFunction(vm, "gcHeapSize", functionHeapSize, 0);
+        addFunction(vm, "gcTelemetry", functionGCTelemetry, 0);
+        addFunction(vm, "allocationSites", functionAllocationSites, 1);
+        addFunction(vm, "structureMemoryStatistics", functionStructureMemoryStatistics, 0);
+        addFunction(vm, "readCodeBlockLifecycleLog", functionReadCodeBlockLifecycleLog, 1);
         addFunction(vm, "MemoryFootprint", functionCreateMemoryFootprint, 0);
         addFunction(vm, "resetMemoryPeak", functionResetMemoryPeak, 0);
         addFunction(vm, "addressOf", functionAddressOf, 1);
@@ -594,6 +607,7 @@ private:
         addFunction(vm, "platformSupportsSamplingProfiler", functionPlatformSupportsSamplingProfiler, 0);
         addFunction(vm, "generateHeapSnapshot", functionGenerateHeapSnapshot, 0);
         addFunction(vm, "generateHeapSnapshotForGCDebugging", functionGenerateHeapSnapshotForGCDebugging, 0);
+        addFunction(vm, "writeHeapSnapshot", functionWriteHeapSnapshot, 2);
         addFunction(vm, "resetSuperSamplerState", functionResetSuperSamplerState, 0);
         addFunction(vm, "ensureArrayStorage", functionEnsureArrayStorage, 0);
 #if ENABLE(SAMPLING_PROFILER)
@@ -1418,6 +1432,68 @@ JSC_DEFINE_HOST_FUNCTION(functionHeapSize, (JSGlobalObject* globalObject, CallFr
     return JSValue::encode(jsNumber(vm.heap.size()));
 }
 
+// Returns the recent GCTelemetryRecords as a JSON string. Use JSON.parse() to inspect them.
+JSC_DEFINE_HOST_FUNCTION(functionGCTelemetry, (JSGlobalObject* globalObject, CallFrame*))
+{
+    VM& vm = globalObject->vm();
+    return JSValue::encode(jsString(vm, vm.heap.gcTelemetry().toJSON()));
+}
+
+// Returns the allocation sites retaining the most memory as a JSON string, or undefined unless
+// the shell was run with --allocationSamplingInterval=<bytes>. Takes an optional limit.
+JSC_DEFINE_HOST_FUNCTION(functionAllocationSites, (JSGlobalObject* globalObject, CallFrame* callFrame))
+{
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+    AllocationSiteProfiler* profiler = vm.heap.allocationSiteProfiler();
+    if (!profiler)
+        return JSValue::encode(jsUndefined());
+
+    unsigned limit = 100;
+    if (!callFrame->argument(0).isUndefined()) {
+        limit = callFrame->argument(0).toUInt32(globalObject);
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+    }
+    return JSValue::encode(jsString(vm, profiler->toJSON(limit)));
+}
+
+// Returns how much memory the live Structures and their property tables use as a JSON string.
+JSC_DEFINE_HOST_FUNCTION(functionStructureMemoryStatistics, (JSGlobalObject* globalObject, CallFrame*))
+{
+    VM& vm = globalObject->vm();
+    JSLockHolder lock(vm);
+    Structure::MemoryStatistics statistics = Structure::memoryStatistics(vm);
+
+    StringBuilder json;
+    json.append("{\"structures\":", statistics.numberOfStructures);
+    json.append(",\"propertyTables\":", statistics.numberOfPropertyTables);
+    json.append(",\"sharedPropertyTables\":", statistics.numberOfSharedPropertyTables);
+    json.append(",\"structureBytes\":", statistics.structureBytes);
+    json.append(",\"propertyTableBytes\":", statistics.propertyTableBytes);
+    json.append(",\"rareDataBytes\":", statistics.rareDataBytes);
+    json.append(",\"bytesPerStructure\":", statistics.bytesPerStructure());
+    json.append('}');
+    return JSValue::encode(jsString(vm, json.toString()));
+}
+
+// Decodes a log written with --codeBlockLifecycleLogFile into a JSON string.
+JSC_DEFINE_HOST_FUNCTION(functionReadCodeBlockLifecycleLog, (JSGlobalObject* globalObject, CallFrame* callFrame))
+{
+    VM& vm = globalObject->vm();
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    String fileName = callFrame->argument(0).toWTFString(globalObject);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    if (Profiler::LifecycleLog::isEnabled())
+        Profiler::LifecycleLog::singleton().flush();
+
+    String json = Profiler::LifecycleLog::readAsJSON(fileName.utf8().data());
+    if (json.isNull())
+        return throwVMError(globalObject, scope, "Could not read CodeBlock lifecycle log.");
+    return JSValue::encode(jsString(vm, json));
+}
+
 class JSCMemoryFootprint : public JSDestructibleObject {
     using Base = JSDestructibleObject;
 public:
@@ -2556,6 +2632,46 @@ JSC_DEFINE_HOST_FUNCTION(functionGenerateHeapSnapshotForGCDebugging, (JSGlobalOb
     return JSValue::encode(jsString(vm, jsonString));
 }
 
+// writeHeapSnapshot(path, [format]) streams a snapshot straight to a file, where format is "json"
+// (the default) or "binary".
+JSC_DEFINE_HOST_FUNCTION(functionWriteHeapSnapshot, (JSGlobalObject* globalObject, CallFrame* callFrame))
+{
+    VM& vm = globalObject->vm();
+    JSLockHolder lock(vm);
+    auto scope = DECLARE_THROW_SCOPE(vm);
+
+    String path = callFrame->argument(0).toWTFString(globalObject);
+    RETURN_IF_EXCEPTION(scope, encodedJSValue());
+
+    HeapSnapshotFormat format = HeapSnapshotFormat::JSON;
+    if (!callFrame->argument(1).isUndefined()) {
+        String formatName = callFrame->argument(1).toWTFString(globalObject);
+        RETURN_IF_EXCEPTION(scope, encodedJSValue());
+        if (formatName == "binary")
+            format = HeapSnapshotFormat::Binary;
+        else if (formatName != "json")
+            return throwVMTypeError(globalObject, scope, "Heap snapshot format must be \"json\" or \"binary\""_s);
+    }
+
+    auto handle = FileSystem::openFile(path, FileSystem::FileOpenMode::Write);
+    if (!FileSystem::isHandleValid(handle))
+        return throwVMError(globalObject, scope, createError(globalObject, makeString("Could not open ", path)));
+
+    bool success;
+    {
+        DeferGCForAWhile deferGC(vm.heap); // Prevent concurrent GC from interfering with the full GC that the snapshot does.
+
+        HeapSnapshotBuilder snapshotBuilder(vm.ensureHeapProfiler());
+        snapshotBuilder.buildSnapshot();
+        success = snapshotBuilder.writeToFile(format, handle);
+    }
+    FileSystem::closeFile(handle);
+
+    if (!success)
+        return throwVMError(globalObject, scope, createError(globalObject, makeString("Could not write heap snapshot to ", path)));
+    return JSValue::encode(jsUndefined());
+}
+
 JSC_DEFINE_HOST_FUNCTION(functionResetSuperSamplerState, (JSGlobalObject*, CallFrame*))
 {
     resetSuperSamplerState();
@@ -3483,6 +3599,11 @@ int runJSC(const CommandLine& options, bool isWorker, const Func& func)
 
     vm.codeCache()->write(vm);
 
+    if (ProfileCache* profileCache = vm.profileCache()) {
+        JSLockHolder locker(vm);
+        profileCache->recordAndSave(vm);
+    }
+
     if (options.m_destroyVM || isWorker) {
         JSLockHolder locker(vm);
         // This is needed because we don't want the worker's main
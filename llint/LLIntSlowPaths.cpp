@@ -58,6 +58,7 @@
 #include "LLIntThunks.h"
 #include "ObjectConstructor.h"
 #include "ObjectPropertyConditionSet.h"
+#include "ProfilerLifecycleLog.h"
 #include "ProtoCallFrameInlines.h"
 #include "RegExpObject.h"
 #include "ShadowChicken.h"
@@ -483,6 +484,7 @@ LLINT_SLOW_PATH_DECL(loop_osr)
         LLINT_RETURN_TWO(nullptr, nullptr);
     
     CODEBLOCK_LOG_EVENT(codeBlock, "osrEntry", ("at ", loopOSREntryBytecodeIndex));
+    Profiler::logLifecycleEvent(codeBlock, Profiler::LifecycleEventKind::OSREntry, JITType::BaselineJIT, loopOSREntryBytecodeIndex);
 
     ASSERT(codeBlock->jitType() == JITType::BaselineJIT);
 
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "ProfilerLifecycleLog.h"
+
+#include "CodeBlock.h"
+#include "DFGCompilationMode.h"
+#include "ExitKind.h"
+#include "ProfilerJettisonReason.h"
+#include <mutex>
+#include <stdio.h>
+#include <wtf/ScopeExit.h>
+#include <wtf/WallTime.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC { namespace Profiler {
+
+static constexpr size_t bufferCapacity = 1024;
+static constexpr uint32_t lifecycleLogVersion = 1;
+static constexpr char lifecycleLogMagic[8] = "JSCLCYC";
+
+struct LifecycleLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint64_t startTime; // Milliseconds since the epoch.
+};
+
+LifecycleLog& LifecycleLog::singleton()
+{
+    static LazyNeverDestroyed<LifecycleLog> log;
+    static std::once_flag onceFlag;
+    std::call_once(onceFlag, [] {
+        log.construct(Options::codeBlockLifecycleLogFile());
+        atexit([] {
+            log->flush();
+        });
+    });
+    return log;
+}
+
+LifecycleLog::LifecycleLog(const char* filename)
+    : m_startTime(MonotonicTime::now())
+{
+    m_file = fopen(filename, "wb");
+    if (!m_file) {
+        dataLogLn("Could not open ", filename, " for the CodeBlock lifecycle log");
+        return;
+    }
+
+    LifecycleLogHeader header;
+    memcpy(header.magic, lifecycleLogMagic, sizeof(header.magic));
+    header.version = lifecycleLogVersion;
+    header.recordSize = sizeof(LifecycleRecord);
+    header.startTime = static_cast<uint64_t>(WallTime::now().secondsSinceEpoch().milliseconds());
+    fwrite(&header, sizeof(header), 1, m_file);
+    m_buffer.reserveInitialCapacity(bufferCapacity);
+}
+
+bool LifecycleLog::isSampled(unsigned hash)
+{
+    double sampleRate = Options::codeBlockLifecycleLogSampleRate();
+    if (sampleRate >= 1)
+        return true;
+    // Scramble the hash so that which functions get sampled does not depend on how their source
+    // text happens to hash.
+    uint32_t scrambled = hash * 2654435761u;
+    return scrambled < sampleRate * std::numeric_limits<uint32_t>::max();
+}
+
+void LifecycleLog::log(CodeBlock* codeBlock, LifecycleEventKind kind, JITType jitType, BytecodeIndex bytecodeIndex, uint32_t data, uint16_t extra)
+{
+    if (!codeBlock)
+        return;
+
+    // Options::alwaysComputeHash() is forced on while logging, so compiler threads should always
+    // find the hash already computed.
+    if (!codeBlock->hasHash() && !codeBlock->isSafeToComputeHash())
+        return;
+    unsigned hash = codeBlock->hash().hash();
+    if (!isSampled(hash))
+        return;
+
+    LifecycleRecord record { 0, hash, bytecodeIndex.asBits(), data, kind, static_cast<uint8_t>(jitType), extra };
+    MonotonicTime now = MonotonicTime::now();
+    auto locker = holdLock(m_lock);
+    if (!m_file)
+        return;
+    record.timestamp = static_cast<uint64_t>((now - m_startTime).microseconds());
+    m_buffer.append(record);
+    if (m_buffer.size() >= bufferCapacity)
+        flush(locker);
+}
+
+void LifecycleLog::flush()
+{
+    auto locker = holdLock(m_lock);
+    flush(locker);
+}
+
+void LifecycleLog::flush(const AbstractLocker&)
+{
+    if (!m_file || m_buffer.isEmpty())
+        return;
+    fwrite(m_buffer.data(), sizeof(LifecycleRecord), m_buffer.size(), m_file);
+    fflush(m_file);
+    m_buffer.shrink(0);
+}
+
+static const char* lifecycleEventKindName(LifecycleEventKind kind)
+{
+    switch (kind) {
+    case LifecycleEventKind::Compile:
+        return "compile";
+    case LifecycleEventKind::InstallCode:
+        return "installCode";
+    case LifecycleEventKind::OSREntry:
+        return "osrEntry";
+    case LifecycleEventKind::OSRExit:
+        return "osrExit";
+    case LifecycleEventKind::Jettison:
+        return "jettison";
+    }
+    return nullptr;
+}
+
+String LifecycleLog::readAsJSON(const char* filename)
+{
+    FILE* file = fopen(filename, "rb");
+    if (!file)
+        return String();
+    auto closeFile = makeScopeExit([&] {
+        fclose(file);
+    });
+
+    LifecycleLogHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1
+        || memcmp(header.magic, lifecycleLogMagic, sizeof(header.magic))
+        || header.version != lifecycleLogVersion
+        || header.recordSize != sizeof(LifecycleRecord))
+        return String();
+
+    StringBuilder builder;
+    builder.append("{\"startTime\":", header.startTime, ",\"events\":[");
+    LifecycleRecord record;
+    bool first = true;
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        const char* kindName = lifecycleEventKindName(record.kind);
+        if (!kindName || record.jitType > static_cast<uint8_t>(JITType::FTLJIT))
+            return String();
+
+        if (!first)
+            builder.append(',');
+        first = false;
+        builder.append("{\"time\":", record.timestamp, ",\"codeBlock\":\"", toCString(CodeBlockHash(record.codeBlockHash)).data(),
+            "\",\"event\":\"", kindName, "\",\"tier\":\"", toCString(static_cast<JITType>(record.jitType)).data(), '"');
+
+        BytecodeIndex bytecodeIndex = BytecodeIndex::fromBits(record.bytecodeIndex);
+        if (bytecodeIndex)
+            builder.append(",\"bytecodeIndex\":\"", toCString(bytecodeIndex).data(), '"');
+
+        switch (record.kind) {
+        case LifecycleEventKind::Compile:
+            builder.append(",\"compileTimeUS\":", record.data);
+#if ENABLE(DFG_JIT)
+            if (record.extra > DFG::FTLForOSREntryMode)
+                return String();
+            builder.append(",\"mode\":\"", toCString(static_cast<DFG::CompilationMode>(record.extra)).data(), '"');
+#endif
+            break;
+        case LifecycleEventKind::OSRExit:
+            if (record.data > BigInt32Overflow)
+                return String();
+            builder.append(",\"exitKind\":\"", exitKindToString(static_cast<ExitKind>(record.data)), '"');
+            break;
+        case LifecycleEventKind::Jettison:
+            if (record.data > JettisonDueToVMTraps)
+                return String();
+            builder.append(",\"reason\":\"", toCString(static_cast<JettisonReason>(record.data)).data(), "\",\"osrExits\":", record.extra);
+            break;
+        case LifecycleEventKind::InstallCode:
+        case LifecycleEventKind::OSREntry:
+            break;
+        }
+        builder.append('}');
+    }
+    builder.append("]}");
+    return builder.toString();
+}
+
+} } // namespace JSC::Profiler
@@ -0,0 +1,101 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "BytecodeIndex.h"
+#include "Options.h"
+#include <stdio.h>
+#include <wtf/Lock.h>
+#include <wtf/MonotonicTime.h>
+#include <wtf/NeverDestroyed.h>
+#include <wtf/Vector.h>
+#include <wtf/text/WTFString.h>
+
+namespace JSC {
+
+class CodeBlock;
+enum class JITType : uint8_t;
+
+namespace Profiler {
+
+// A compact, append-only log of what happens to CodeBlocks over their lifetime. Unlike Database,
+// which keeps everything in memory and instruments the code it compiles, this only writes a
+// fixed-size record at each tier transition, so it is cheap enough to leave on in production.
+// Sampling is per CodeBlockHash, so every event for a sampled function is kept.
+
+enum class LifecycleEventKind : uint8_t {
+    Compile, // data = compile time in microseconds, extra = DFG::CompilationMode, jitType = None if the compile failed.
+    InstallCode,
+    OSREntry,
+    OSRExit, // data = ExitKind. Logged when an exit site fires for the first time.
+    Jettison, // data = JettisonReason, extra = OSR exit count of the jettisoned code, saturated.
+};
+
+struct LifecycleRecord {
+    uint64_t timestamp; // Microseconds since the log was opened.
+    uint32_t codeBlockHash;
+    uint32_t bytecodeIndex; // BytecodeIndex::asBits().
+    uint32_t data;
+    LifecycleEventKind kind;
+    uint8_t jitType;
+    uint16_t extra;
+};
+static_assert(sizeof(LifecycleRecord) == 24, "The lifecycle log file format depends on the record size");
+
+class LifecycleLog {
+    WTF_MAKE_FAST_ALLOCATED;
+    WTF_MAKE_NONCOPYABLE(LifecycleLog);
+public:
+    static bool isEnabled() { return !!Options::codeBlockLifecycleLogFile(); }
+    JS_EXPORT_PRIVATE static LifecycleLog& singleton();
+
+    void log(CodeBlock*, LifecycleEventKind, JITType, BytecodeIndex = BytecodeIndex(), uint32_t data = 0, uint16_t extra = 0);
+    JS_EXPORT_PRIVATE void flush();
+
+    // Reads a log written by any process and converts it to JSON, one object per event.
+    // Returns a null string if the file is missing or malformed.
+    JS_EXPORT_PRIVATE static String readAsJSON(const char* filename);
+
+private:
+    friend class LazyNeverDestroyed<LifecycleLog>;
+    LifecycleLog(const char* filename);
+
+    void flush(const AbstractLocker&);
+    static bool isSampled(unsigned hash);
+
+    Lock m_lock;
+    FILE* m_file { nullptr };
+    MonotonicTime m_startTime;
+    Vector<LifecycleRecord> m_buffer;
+};
+
+inline void logLifecycleEvent(CodeBlock* codeBlock, LifecycleEventKind kind, JITType jitType, BytecodeIndex bytecodeIndex = BytecodeIndex(), uint32_t data = 0, uint16_t extra = 0)
+{
+    if (UNLIKELY(LifecycleLog::isEnabled()))
+        LifecycleLog::singleton().log(codeBlock, kind, jitType, bytecodeIndex, data, extra);
+}
+
+} } // namespace JSC::Profiler
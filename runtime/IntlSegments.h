@@ -34,6 +34,7 @@ public:
     using Base = JSNonFinalObject;
 
     static constexpr bool needsDestruction = true;
+    static constexpr bool hasThreadSafeDestructor = true;
 
     static void destroy(JSCell* cell)
     {
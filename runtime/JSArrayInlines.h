@@ -160,7 +160,7 @@ ALWAYS_INLINE void JSArray::pushInline(JSGlobalObject* globalObject, JSValue val
         if (length < butterfly->vectorLength()) {
             butterfly->contiguous().at(this, length).setWithoutWriteBarrier(value);
             butterfly->setPublicLength(length + 1);
-            vm.heap.writeBarrier(this, value);
+            vm.heap.writeBarrierForElement(this, length, value);
             return;
         }
 
@@ -232,9 +232,10 @@ ALWAYS_INLINE void JSArray::pushInline(JSGlobalObject* globalObject, JSValue val
         // Fast case - push within vector, always update m_length & m_numValuesInVector.
         unsigned length = storage->length();
         if (length < storage->vectorLength()) {
-            storage->m_vector[length].set(vm, this, value);
+            storage->m_vector[length].setWithoutWriteBarrier(value);
             storage->setLength(length + 1);
             ++storage->m_numValuesInVector;
+            vm.heap.writeBarrierForElement(this, length, value);
             return;
         }
 
@@ -85,6 +85,9 @@ public:
     static constexpr unsigned StructureFlags = 0;
 
     static constexpr bool needsDestruction = false;
+    // Set this if destroy() only releases memory and thread-safe reference counts, so that it may
+    // run on a heap helper thread. Only IsoSubspace cell types look at this.
+    static constexpr bool hasThreadSafeDestructor = false;
 
     static constexpr uint8_t numberOfLowerTierCells = 8;
 
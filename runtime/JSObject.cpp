@@ -931,7 +931,7 @@ bool JSObject::putByIndex(JSCell* cell, JSGlobalObject* globalObject, unsigned p
         butterfly->contiguous().at(thisObject, propertyName).setWithoutWriteBarrier(value);
         if (propertyName >= butterfly->publicLength())
             butterfly->setPublicLength(propertyName + 1);
-        vm.heap.writeBarrier(thisObject, value);
+        vm.heap.writeBarrierForElement(thisObject, propertyName, value);
         return true;
     }
         
@@ -975,7 +975,8 @@ bool JSObject::putByIndex(JSCell* cell, JSGlobalObject* globalObject, unsigned p
         } else if (!valueSlot)
             ++storage->m_numValuesInVector;
         
-        valueSlot.set(vm, thisObject, value);
+        valueSlot.setWithoutWriteBarrier(value);
+        vm.heap.writeBarrierForElement(thisObject, propertyName, value);
         return true;
     }
         
@@ -455,7 +455,7 @@ public:
             butterfly->contiguous().at(this, i).setWithoutWriteBarrier(v);
             if (i >= butterfly->publicLength())
                 butterfly->setPublicLength(i + 1);
-            vm.heap.writeBarrier(this, v);
+            vm.heap.writeBarrierForElement(this, i, v);
             break;
         }
         case ALL_DOUBLE_INDEXING_TYPES: {
@@ -478,12 +478,13 @@ public:
             ArrayStorage* storage = butterfly->arrayStorage();
             WriteBarrier<Unknown>& x = storage->m_vector[i];
             JSValue old = x.get();
-            x.set(vm, this, v);
+            x.setWithoutWriteBarrier(v);
             if (!old) {
                 ++storage->m_numValuesInVector;
                 if (i >= storage->length())
                     storage->setLength(i + 1);
             }
+            vm.heap.writeBarrierForElement(this, i, v);
             break;
         }
         case ALL_BLANK_INDEXING_TYPES:
@@ -470,6 +470,8 @@ void Options::recomputeDependentOptions()
         || Options::reportBaselineCompileTimes()
         || Options::reportDFGCompileTimes()
         || Options::reportFTLCompileTimes()
+        || Options::reportDFGPlanTimes()
+        || Options::codeBlockLifecycleLogFile()
         || Options::logPhaseTimes()
         || Options::verboseCFA()
         || Options::verboseDFGFailure()
@@ -539,6 +541,13 @@ void Options::recomputeDependentOptions()
     else if (Options::randomIntegrityAuditRate() > 1.0)
         Options::randomIntegrityAuditRate() = 1.0;
 
+    // The hot region holds every function body, so never let cold code take more than half the
+    // pool. This also keeps negative or NaN fractions from turning into a bogus region size.
+    if (!(Options::jitColdCodeRegionFraction() > 0))
+        Options::jitColdCodeRegionFraction() = 0;
+    else if (Options::jitColdCodeRegionFraction() > 0.5)
+        Options::jitColdCodeRegionFraction() = 0.5;
+
     if (!Options::allowUnsupportedTiers()) {
 #define DISABLE_TIERS(option, flags, ...) do { \
             if (!Options::option())            \
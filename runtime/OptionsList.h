@@ -99,6 +99,7 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     v(Bool, crashOnDisallowedVMEntry, ASSERT_ENABLED, Normal, "Forces a crash if we attempt to enter the VM when disallowed") \
     v(Bool, crashIfCantAllocateJITMemory, false, Normal, nullptr) \
     v(Unsigned, jitMemoryReservationSize, 0, Normal, "Set this number to change the executable allocation size in ExecutableAllocatorFixedVMPool. (In bytes.)") \
+    v(Double, jitColdCodeRegionFraction, 0, Normal, "Fraction of the executable memory pool set aside for cold code like inline cache stubs, lazy slow paths and OSR exits, so that it does not fragment the memory holding function bodies. 0 disables the cold region, and it is capped at 0.5.") \
     \
     v(Bool, forceCodeBlockLiveness, false, Normal, nullptr) \
     v(Bool, forceICFailure, false, Normal, nullptr) \
@@ -165,10 +166,15 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     v(Bool, verboseFTLOSRExit, false, Normal, nullptr) \
     v(Bool, verboseCallLink, false, Normal, nullptr) \
     v(Bool, verboseCompilationQueue, false, Normal, nullptr) \
+    v(Bool, useDFGWorklistPriorities, false, Normal, "If true, DFG and FTL compiler threads pick the queued plan with the highest estimated benefit instead of the oldest one.") \
+    v(Double, maximumDFGPlanQueueDelay, 0, Normal, "If non-zero, DFG plans that have waited in the queue for longer than this many milliseconds are cancelled when another plan for the same VM is enqueued.") \
     v(Bool, reportCompileTimes, false, Normal, "dumps JS function signature and the time it took to compile in all tiers") \
     v(Bool, reportBaselineCompileTimes, false, Normal, "dumps JS function signature and the time it took to BaselineJIT compile") \
     v(Bool, reportDFGCompileTimes, false, Normal, "dumps JS function signature and the time it took to DFG and FTL compile") \
     v(Bool, reportFTLCompileTimes, false, Normal, "dumps JS function signature and the time it took to FTL compile") \
+    v(Bool, reportDFGPlanTimes, false, Normal, "dumps a JSON object per DFG and FTL plan with its priority, queue delay and compile time") \
+    v(OptionString, codeBlockLifecycleLogFile, nullptr, Normal, "If set, compiles, code installs, OSR entries and exits, and jettisons of CodeBlocks are logged to this file in a compact binary format") \
+    v(Double, codeBlockLifecycleLogSampleRate, 1.0, Normal, "Fraction of functions, chosen by CodeBlockHash, whose lifecycle events are logged") \
     v(Bool, reportTotalCompileTimes, false, Normal, nullptr) \
     v(Bool, reportTotalPhaseTimes, false, Normal, "This prints phase times at the end of running script inside jsc.cpp") \
     v(Bool, reportParseTimes, false, Normal, "dumps JS function signature and the time it took to parse") \
@@ -253,6 +259,8 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     \
     v(Bool, useConcurrentJIT, true, Normal, "allows the DFG / FTL compilation in threads other than the executing JS thread") \
     v(Unsigned, numberOfDFGCompilerThreads, computeNumberOfWorkerThreads(3, 2) - 1, Normal, nullptr) \
+    v(Unsigned, numberOfBaselineCompilerThreads, 1, Normal, "number of threads that compile CodeBlocks with the baseline JIT concurrently") \
+    v(Unsigned, maximumInstructionsSizeForMainThreadBaselineCompile, UINT_MAX, Normal, "If all baseline JIT threads are busy, CodeBlocks with more bytecode than this wait in the queue and keep running in the LLInt instead of being compiled on the main thread.") \
     v(Unsigned, numberOfFTLCompilerThreads, computeNumberOfWorkerThreads(MAXIMUM_NUMBER_OF_FTL_COMPILER_THREADS, 2) - 1, Normal, nullptr) \
     v(Int32, priorityDeltaOfDFGCompilerThreads, computePriorityDeltaOfWorkerThreads(-1, 0), Normal, nullptr) \
     v(Int32, priorityDeltaOfFTLCompilerThreads, computePriorityDeltaOfWorkerThreads(-2, 0), Normal, nullptr) \
@@ -331,11 +339,19 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     v(Unsigned, maximumDirectCallStackSize, 200, Normal, nullptr) \
     \
     v(Unsigned, minimumNumberOfScansBetweenRebalance, 100, Normal, nullptr) \
+    v(Bool, useWorkStealingMarking, false, Normal, "Parallel markers publish full collector mark stack segments to per-marker lock-free deques that idle markers steal from, instead of donating through the shared mark stack.") \
+    v(Bool, useMarkedBlockBitmapIndex, false, Normal, "Conservative scanning checks candidate block addresses against a two-level bitmap instead of a Bloom filter and a hash set.") \
+    v(Bool, useEphemeronIndex, false, Normal, "Index WeakMap entries with unmarked keys by key during marking, so that marking a key marks its values without another constraint fixpoint iteration.") \
+    v(Bool, useArrayCardMarking, false, Normal, "Runtime stores into elements of large marked arrays dirty a card in a remembered set instead of rescanning the whole array.") \
+    v(Unsigned, minimumArrayLengthForCardMarking, 4096, Normal, "Arrays whose vector length is at least this large use card marking when useArrayCardMarking is enabled.") \
     v(Unsigned, numberOfGCMarkers, computeNumberOfGCMarkers(8), Normal, nullptr) \
     v(Bool, useParallelMarkingConstraintSolver, true, Normal, nullptr) \
     v(Unsigned, opaqueRootMergeThreshold, 1000, Normal, nullptr) \
     v(Double, minHeapUtilization, 0.8, Normal, nullptr) \
     v(Double, minMarkedBlockUtilization, 0.9, Normal, nullptr) \
+    v(Bool, useSparseBlockDraining, false, Normal, "If true, full collections stop allocating into sparse blocks without destructors so that they can empty out and be freed") \
+    v(Double, maxMarkedBlockUtilizationForDraining, 0.25, Normal, "Blocks whose live cells take up less than this fraction of the block can be drained") \
+    v(Double, maxDirectoryUtilizationForDraining, 0.6, Normal, "Only drain blocks of a size class whose live cells take up less than this fraction of its non-empty blocks") \
     v(Unsigned, slowPathAllocsBetweenGCs, 0, Normal, "force a GC on every Nth slow path alloc, where N is specified by this option") \
     \
     v(Double, percentCPUPerMBForFullTimer, 0.0003125, Normal, nullptr) \
@@ -348,6 +364,11 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     v(Bool, useZombieMode, false, Normal, "debugging option to scribble over dead objects with 0xbadbeef0") \
     v(Bool, useImmortalObjects, false, Normal, "debugging option to keep all objects alive forever") \
     v(Bool, sweepSynchronously, false, Normal, "debugging option to sweep all dead objects synchronously at GC end before resuming mutator") \
+    v(Bool, useConcurrentSweeping, false, Normal, "If true, heap helper threads build free lists for blocks without destructors after each GC, ahead of the allocator") \
+    v(Bool, useConcurrentDestruction, false, Normal, "If true, heap helper threads run the destructors of dead cells whose type has a thread-safe destructor after each GC, and build free lists for their blocks") \
+    v(Bool, useHugePagesForMarkedBlocks, false, Normal, "If true, MarkedBlocks are carved out of 2MB chunks that are advised to be backed by transparent huge pages where the OS supports it") \
+    v(Bool, useSharedPropertyTables, false, Normal, "If true, Structure transitions that keep the property table of their predecessor share it instead of copying it, until one of them modifies it") \
+    v(Unsigned, maximumNumberOfStructureIDs, 1 << 24, Normal, "Number of StructureIDs each VM reserves address space for. Creating more live Structures than this crashes. Values above what the StructureID encoding can represent are clamped") \
     v(Unsigned, maxSingleAllocationSize, 0, Configurable, "debugging option to limit individual allocations to a max size (0 = limit not set, N = limit size in bytes)") \
     \
     v(GCLogLevel, logGC, GCLogging::None, Normal, "debugging option to log GC activity (0 = None, 1 = Basic, 2 = Verbose)") \
@@ -356,8 +377,18 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     v(Bool, forceGCSlowPaths, false, Normal, "If true, we will force all JIT fast allocations down their slow paths.") \
     v(Bool, forceDidDeferGCWork, false, Normal, "If true, we will force all DeferGC destructions to perform a GC.") \
     v(Unsigned, gcMaxHeapSize, 0, Normal, nullptr) \
+    v(Size, heapFootprintLimit, 0, Normal, "If non-zero, the collector grows the heap so as to keep the process memory footprint under this many bytes (see heapFootprintTargetRatio).") \
+    v(Bool, useEdenSizeAutotuning, false, Normal, "If true, the Eden budget grows while few objects survive Eden collections, and shrinks when many do or when their pauses exceed edenPauseTargetMS") \
+    v(Double, edenPauseTargetMS, 5, Normal, "pause time that useEdenSizeAutotuning tries to keep Eden collections under") \
+    v(Double, maximumEdenGrowthFactor, 8, Normal, "largest multiple of its usual size that useEdenSizeAutotuning lets the Eden budget grow to") \
+    v(Bool, useCGroupMemoryLimit, false, Normal, "If heapFootprintLimit is 0, use the memory.max of the cgroup v2 of the process as the footprint limit, and its memory.current as the footprint.") \
+    v(Double, heapFootprintTargetRatio, 0.9, Normal, "fraction of the footprint limit the collector aims to stay under") \
     v(Unsigned, forceRAMSize, 0, Normal, nullptr) \
+    v(Double, minimumEdenFullnessForIdleCollection, 0.5, Normal, "fraction of the Eden budget that must have been allocated before idle time is used to start a collection") \
     v(Bool, recordGCPauseTimes, false, Normal, nullptr) \
+    v(Unsigned, numberOfGCTelemetryRecords, 64, Normal, "number of recent collections for which per-phase timings are kept (0 disables)") \
+    v(Size, allocationSamplingInterval, 0, Normal, "If non-zero, record the JS stack of about one allocation per this many bytes allocated, and track how many bytes each allocation site retains across collections.") \
+    v(Unsigned, allocationSamplingStackDepth, 4, Normal, "number of JS frames recorded per allocation sample") \
     v(Bool, dumpHeapStatisticsAtVMDestruction, false, Normal, nullptr) \
     v(Bool, forceCodeBlockToJettisonDueToOldAge, false, Normal, "If true, this means that anytime we can jettison a CodeBlock due to old age, we do.") \
     v(Bool, useEagerCodeBlockJettisonTiming, false, Normal, "If true, the time slices for jettisoning a CodeBlock due to old age are shrunk significantly.") \
@@ -377,6 +408,8 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     \
     v(Double, randomIntegrityAuditRate, 0.05, Normal, "Probability of random integrity audits [0.0 - 1.0]") \
     v(Bool, verifyHeap, false, Normal, nullptr) \
+    v(Bool, auditHeapIntegrity, false, Normal, "If true, the collector audits the live cells of the heap on the heap helper threads after each marking phase") \
+    v(Double, heapAuditSampleRate, 1.0, Normal, "Fraction of live cells checked by verifyHeap and auditHeapIntegrity [0.0 - 1.0]") \
     v(Unsigned, numberOfGCCyclesToRecordForVerification, 3, Normal, nullptr) \
     \
     v(Unsigned, exceptionStackTraceLimit, 100, Normal, "Stack trace limit for internal Exception object") \
@@ -508,6 +541,7 @@ JS_EXPORT_PRIVATE bool canUseJITCage();
     v(Unsigned, thresholdForGlobalLexicalBindingEpoch, UINT_MAX, Normal, "Threshold for global lexical binding epoch. If the epoch reaches to this value, CodeBlock metadata for scope operations will be revised globally. It needs to be greater than 1.") \
     v(OptionString, diskCachePath, nullptr, Restricted, nullptr) \
     v(Bool, forceDiskCache, false, Restricted, nullptr) \
+    v(OptionString, profileCacheFile, nullptr, Normal, "If set, value profile predictions and tier-up hints are loaded from this file at VM creation and written back at VM destruction. Typically placed next to the bytecode cache in diskCachePath.") \
     v(Bool, validateAbstractInterpreterState, false, Restricted, nullptr) \
     v(Double, validateAbstractInterpreterStateProbability, 0.5, Normal, nullptr) \
     v(OptionString, dumpJITMemoryPath, nullptr, Restricted, nullptr) \
@@ -0,0 +1,258 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#include "config.h"
+#include "ProfileCache.h"
+
+#include "CodeBlock.h"
+#include "CodeBlockInlines.h"
+#include "HeapInlines.h"
+#include <stdio.h>
+#include <wtf/Atomics.h>
+#include <wtf/HexNumber.h>
+#include <wtf/ProcessID.h>
+#include <wtf/text/StringHasher.h>
+#include <wtf/text/StringBuilder.h>
+
+namespace JSC {
+
+namespace ProfileCacheInternal {
+static constexpr bool verbose = false;
+}
+
+// The cache file starts with a "<magic> <version> <build>" line, followed by one CodeBlock per line in
+// the same text format as FuzzerPredictions:
+// <CodeBlockHash in hex>:<tier>:<prediction in hex>,...
+// Predictions are listed in the order CodeBlock::forEachValueProfile() visits them. Bump the version
+// whenever the line format changes.
+static constexpr const char* profileCacheMagic = "JSCProfileCache";
+static constexpr unsigned profileCacheVersion = 3;
+
+// Predictions only mean something to the build that recorded them, since another build may order value
+// profiles or assign SpeculatedType bits differently. This file includes CodeBlock.h and
+// SpeculatedType.h, so like jscBytecodeCacheVersion() this changes whenever those do.
+static constexpr unsigned profileCacheBuildVersion()
+{
+    return StringHasher::computeHash(__DATE__ " " __TIME__);
+}
+
+ProfileCache::ProfileCache(const char* filename)
+    : m_filename(filename)
+{
+    load();
+}
+
+void ProfileCache::load()
+{
+    FILE* file = fopen(m_filename.data(), "r");
+    if (!file)
+        return;
+
+    Vector<char> buffer;
+    char chunk[4096];
+    while (size_t readSize = fread(chunk, 1, sizeof(chunk), file))
+        buffer.append(chunk, readSize);
+    fclose(file);
+
+    // A cache that fails to parse is ignored wholesale; it will be rewritten at exit.
+    HashMap<unsigned, Entry> entries;
+    String contents(buffer.data(), buffer.size());
+    Vector<String> lines = contents.split('\n');
+    if (lines.isEmpty())
+        return;
+    // Files from a different version, or that are not profile caches at all, are always reported since
+    // silently dropping them would look like the cache is not working. Caches from another build are
+    // expected after every update, so those are only reported when verbose.
+    Vector<String> headerParts = lines[0].split(' ');
+    if (headerParts.size() != 3 || headerParts[0] != profileCacheMagic || headerParts[1] != String::number(profileCacheVersion)) {
+        dataLogLn("Ignoring ", m_filename, " since it is not a version ", profileCacheVersion, " profile cache");
+        return;
+    }
+    if (headerParts[2] != makeString(hex(profileCacheBuildVersion()))) {
+        dataLogLnIf(ProfileCacheInternal::verbose, "Ignoring ", m_filename, " since it was written by a different build");
+        return;
+    }
+    for (unsigned i = 1; i < lines.size(); ++i) {
+        Vector<String> lineParts = lines[i].split(':');
+        if (lineParts.size() != 3) {
+            dataLogLnIf(ProfileCacheInternal::verbose, "Ignoring ", m_filename, " since line ", i + 1, " is malformed");
+            return;
+        }
+
+        bool ok;
+        unsigned hash = lineParts[0].toUIntStrict(&ok, 0x10);
+        if (!ok || !HashMap<unsigned, Entry>::isValidKey(hash))
+            return;
+        unsigned tier = lineParts[1].toUIntStrict(&ok);
+        if (!ok || tier > static_cast<unsigned>(Tier::Optimizing))
+            return;
+
+        Entry entry;
+        entry.tier = static_cast<Tier>(tier);
+        for (const String& predictionString : lineParts[2].split(',')) {
+            SpeculatedType prediction = predictionString.toUInt64Strict(&ok, 0x10);
+            if (!ok || !speculationChecked(prediction, SpecFullTop))
+                return;
+            entry.predictions.append(prediction);
+        }
+        entries.set(hash, WTFMove(entry));
+    }
+
+    m_entries = WTFMove(entries);
+    dataLogLnIf(ProfileCacheInternal::verbose, "Loaded ", m_entries.size(), " profile cache entries from ", m_filename);
+}
+
+void ProfileCache::seed(CodeBlock* codeBlock)
+{
+    unsigned hash = codeBlock->hash().hash();
+    if (!HashMap<unsigned, Entry>::isValidKey(hash))
+        return;
+
+    Tier tier = Tier::Interpreter;
+    {
+        auto locker = holdLock(m_lock);
+        auto iter = m_entries.find(hash);
+        if (iter == m_entries.end())
+            return;
+
+        const Entry& entry = iter->value;
+        unsigned numberOfValueProfiles = 0;
+        codeBlock->forEachValueProfile([&] (auto&, bool) {
+            numberOfValueProfiles++;
+        });
+        if (numberOfValueProfiles != entry.predictions.size()) {
+            dataLogLnIf(ProfileCacheInternal::verbose, "Profile cache entry for ", *codeBlock, " is stale");
+            return;
+        }
+
+        ConcurrentJSLocker codeBlockLocker(codeBlock->m_lock);
+        unsigned index = 0;
+        codeBlock->forEachValueProfile([&] (auto& profile, bool) {
+            mergeSpeculation(profile.m_prediction, entry.predictions[index++]);
+        });
+        tier = entry.tier;
+    }
+
+    dataLogLnIf(ProfileCacheInternal::verbose, "Seeded ", *codeBlock, " from the profile cache");
+
+    // The predictions we just merged in are what warm-up would have collected, so there is no reason
+    // to wait for the usual thresholds before tiering up.
+    if (tier >= Tier::Baseline)
+        codeBlock->jitSoon();
+#if ENABLE(JIT)
+    if (tier >= Tier::Optimizing)
+        codeBlock->optimizeSoon();
+#endif
+}
+
+void ProfileCache::record(CodeBlock* codeBlock)
+{
+    if (JITCode::isOptimizingJIT(codeBlock->jitType()))
+        return;
+
+    unsigned hash = codeBlock->hash().hash();
+    if (!HashMap<unsigned, Entry>::isValidKey(hash))
+        return;
+
+    codeBlock->updateAllValueProfilePredictions();
+
+    Entry entry;
+    if (codeBlock->jitType() == JITType::BaselineJIT)
+        entry.tier = Tier::Baseline;
+#if ENABLE(JIT)
+    if (codeBlock->hasOptimizedReplacement())
+        entry.tier = Tier::Optimizing;
+#endif
+    {
+        ConcurrentJSLocker codeBlockLocker(codeBlock->m_lock);
+        codeBlock->forEachValueProfile([&] (auto& profile, bool) {
+            entry.predictions.append(profile.m_prediction);
+        });
+    }
+    if (entry.predictions.isEmpty())
+        return;
+
+    auto locker = holdLock(m_lock);
+    auto result = m_entries.add(hash, Entry());
+    Entry& existing = result.iterator->value;
+    if (result.isNewEntry || existing.predictions.size() != entry.predictions.size()) {
+        existing = WTFMove(entry);
+        return;
+    }
+    // Several CodeBlocks can share a hash, e.g. the same script loaded into two global objects.
+    existing.tier = std::max(existing.tier, entry.tier);
+    for (unsigned i = 0; i < entry.predictions.size(); ++i)
+        mergeSpeculation(existing.predictions[i], entry.predictions[i]);
+}
+
+void ProfileCache::recordAndSave(VM& vm)
+{
+    vm.heap.forEachCodeBlock([&] (CodeBlock* codeBlock) {
+        record(codeBlock);
+    });
+    save();
+}
+
+void ProfileCache::save()
+{
+    StringBuilder builder;
+    builder.append(profileCacheMagic, ' ', profileCacheVersion, ' ', hex(profileCacheBuildVersion()), '\n');
+    {
+        auto locker = holdLock(m_lock);
+        for (auto& iter : m_entries) {
+            const Entry& entry = iter.value;
+            builder.append(hex(iter.key), ':', static_cast<unsigned>(entry.tier), ':');
+            bool first = true;
+            for (SpeculatedType prediction : entry.predictions) {
+                if (!first)
+                    builder.append(',');
+                first = false;
+                builder.append(hex(prediction));
+            }
+            builder.append('\n');
+        }
+    }
+
+    // Write to a temporary file first so that a crash mid-write cannot leave a truncated cache behind.
+    // The name is unique per process and per save, so that concurrent savers (several processes, or
+    // several VMs in one process) never interleave their writes; the last rename wins.
+    static Atomic<unsigned> saveCount;
+    CString temporaryFilename = makeString(m_filename.data(), '.', getCurrentProcessID(), '.', saveCount.exchangeAdd(1), ".tmp").utf8();
+    FILE* file = fopen(temporaryFilename.data(), "w");
+    if (!file) {
+        dataLogLnIf(ProfileCacheInternal::verbose, "Could not open ", temporaryFilename, " for writing");
+        return;
+    }
+    CString contents = builder.toString().utf8();
+    bool success = fwrite(contents.data(), 1, contents.length(), file) == contents.length();
+    success &= !fclose(file);
+    if (success)
+        success = !rename(temporaryFilename.data(), m_filename.data());
+    if (!success)
+        remove(temporaryFilename.data());
+    dataLogLnIf(ProfileCacheInternal::verbose, "Saved ", m_entries.size(), " profile cache entries to ", m_filename, success ? "" : " (failed)");
+}
+
+} // namespace JSC
@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2021 Apple Inc. All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in the
+ *    documentation and/or other materials provided with the distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY APPLE INC. ``AS IS'' AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL APPLE INC. OR
+ * CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ * EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ * PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ * PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ * OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE. 
+ */
+
+#pragma once
+
+#include "SpeculatedType.h"
+#include <wtf/HashMap.h>
+#include <wtf/Lock.h>
+#include <wtf/Vector.h>
+#include <wtf/text/CString.h>
+
+namespace JSC {
+
+class CodeBlock;
+class VM;
+
+// Persists value profile predictions and tier-up hints across process restarts. Entries are keyed by
+// CodeBlockHash, so they survive as long as the source text of the function does. A cache entry is
+// only applied if the CodeBlock has the same number of value profiles it was recorded with, which
+// catches most cases where the bytecode generator changed underneath us.
+class ProfileCache {
+    WTF_MAKE_FAST_ALLOCATED;
+    WTF_MAKE_NONCOPYABLE(ProfileCache);
+public:
+    JS_EXPORT_PRIVATE explicit ProfileCache(const char* filename);
+
+    // Called when a CodeBlock is created, before it first executes.
+    JS_EXPORT_PRIVATE void seed(CodeBlock*);
+
+    // Records every live baseline CodeBlock and writes the cache file. This is called at VM
+    // destruction, but since most clients never destroy their VM, they should call it themselves
+    // before exiting (jsc does). The caller must hold the API lock.
+    JS_EXPORT_PRIVATE void recordAndSave(VM&);
+
+    size_t size() const { return m_entries.size(); }
+
+private:
+    enum class Tier : uint8_t {
+        Interpreter,
+        Baseline,
+        Optimizing,
+    };
+
+    // Reoptimization backoff and compilation failures are deliberately not remembered. The backoff
+    // scales every later tier-up threshold, so carrying it over would delay the first optimizing
+    // compile of a function whose exits have since gone away. Failures depend on options and on
+    // transient conditions like running out of executable memory.
+    struct Entry {
+        Tier tier { Tier::Interpreter };
+        Vector<SpeculatedType> predictions;
+    };
+
+    void load();
+    void record(CodeBlock*);
+    void save();
+
+    CString m_filename;
+    Lock m_lock;
+    HashMap<unsigned, Entry> m_entries;
+};
+
+} // namespace JSC
@@ -195,8 +195,14 @@ public:
     // Copy this PropertyTable, ensuring the copy has at least the capacity provided.
     PropertyTable* copy(VM&, unsigned newCapacity);
 
-#ifndef NDEBUG
+    // A shared table may be referenced by more than one Structure, so it is immutable. Structures
+    // that want to modify it must install their own copy first.
+    bool isShared() const { return m_isShared; }
+    void setIsShared() { m_isShared = true; }
+
     size_t sizeInMemory();
+
+#ifndef NDEBUG
     void checkConsistency();
 #endif
     
@@ -262,6 +268,7 @@ private:
     unsigned m_keyCount;
     unsigned m_deletedCount;
     std::unique_ptr<Vector<PropertyOffset>> m_deletedOffsets;
+    bool m_isShared { false };
 
     static constexpr unsigned MinimumTableSize = 16;
 };
@@ -475,7 +482,6 @@ inline PropertyTable* PropertyTable::copy(VM& vm, unsigned newCapacity)
     return PropertyTable::clone(vm, newCapacity, *this);
 }
 
-#ifndef NDEBUG
 inline size_t PropertyTable::sizeInMemory()
 {
     size_t result = sizeof(PropertyTable) + dataSize();
@@ -483,7 +489,6 @@ inline size_t PropertyTable::sizeInMemory()
         result += (m_deletedOffsets->capacity() * sizeof(PropertyOffset));
     return result;
 }
-#endif
 
 inline void PropertyTable::reinsert(const ValueType& entry)
 {
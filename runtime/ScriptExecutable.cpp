@@ -39,6 +39,7 @@
 #include "LLIntEntrypoint.h"
 #include "ModuleProgramCodeBlock.h"
 #include "ParserError.h"
+#include "ProfilerLifecycleLog.h"
 #include "ProgramCodeBlock.h"
 #include "VMInlines.h"
 
@@ -118,8 +119,10 @@ void ScriptExecutable::installCode(CodeBlock* codeBlock)
 
 void ScriptExecutable::installCode(VM& vm, CodeBlock* genericCodeBlock, CodeType codeType, CodeSpecializationKind kind)
 {
-    if (genericCodeBlock)
+    if (genericCodeBlock) {
         CODEBLOCK_LOG_EVENT(genericCodeBlock, "installCode", ());
+        Profiler::logLifecycleEvent(genericCodeBlock, Profiler::LifecycleEventKind::InstallCode, genericCodeBlock->jitType());
+    }
     
     CodeBlock* oldCodeBlock = nullptr;
     
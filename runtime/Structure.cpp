@@ -29,9 +29,11 @@
 
 #include "BuiltinNames.h"
 #include "DumpContext.h"
+#include "HeapIterationScope.h"
 #include "JSCInlines.h"
 #include "PropertyMapHashTable.h"
 #include "PropertyNameArray.h"
+#include "SubspaceInlines.h"
 #include <wtf/CommaPrinter.h>
 #include <wtf/NeverDestroyed.h>
 #include <wtf/RefPtr.h>
@@ -163,6 +165,31 @@ void Structure::dumpStatistics()
 #endif
 }
 
+Structure::MemoryStatistics Structure::memoryStatistics(VM& vm)
+{
+    MemoryStatistics statistics;
+    HashSet<PropertyTable*> sharedTables;
+
+    HeapIterationScope iterationScope(vm.heap);
+    vm.structureSpace.forEachLiveCell([&] (HeapCell* cell, HeapCell::Kind) {
+        Structure* structure = static_cast<Structure*>(cell);
+        statistics.numberOfStructures++;
+        statistics.structureBytes += sizeof(Structure);
+        if (structure->hasRareData())
+            statistics.rareDataBytes += sizeof(StructureRareData);
+
+        PropertyTable* table = structure->propertyTableOrNull();
+        if (!table)
+            return;
+        if (table->isShared() && !sharedTables.add(table).isNewEntry)
+            return;
+        statistics.numberOfPropertyTables++;
+        statistics.propertyTableBytes += table->sizeInMemory();
+    });
+    statistics.numberOfSharedPropertyTables = sharedTables.size();
+    return statistics;
+}
+
 #if ASSERT_ENABLED
 void Structure::validateFlags()
 {
@@ -705,7 +732,7 @@ Structure* Structure::changePrototypeTransition(VM& vm, Structure* structure, JS
 
     transition->m_prototype.set(vm, transition, prototype);
 
-    PropertyTable* table = structure->copyPropertyTableForPinning(vm);
+    PropertyTable* table = structure->sharePropertyTableForPinning(vm);
     transition->pin(holdLock(transition->m_lock), vm, table);
     transition->setMaxOffset(vm, structure->maxOffset());
     
@@ -797,7 +824,7 @@ Structure* Structure::toDictionaryTransition(VM& vm, Structure* structure, Dicti
     
     Structure* transition = create(vm, structure, deferred);
 
-    PropertyTable* table = structure->copyPropertyTableForPinning(vm);
+    PropertyTable* table = structure->sharePropertyTableForPinning(vm);
     transition->pin(holdLock(transition->m_lock), vm, table);
     transition->setMaxOffset(vm, structure->maxOffset());
     transition->setDictionaryKind(kind);
@@ -837,7 +864,7 @@ PropertyTable* Structure::takePropertyTableOrCloneIfPinned(VM& vm)
     // This must always return a property table. It can't return null.
     PropertyTable* result = propertyTableOrNull();
     if (result) {
-        if (isPinnedPropertyTable())
+        if (isPinnedPropertyTable() || result->isShared())
             return result->copy(vm, result->size() + 1);
         ConcurrentJSLocker locker(m_lock);
         setPropertyTable(vm, nullptr);
@@ -887,7 +914,12 @@ Structure* Structure::nonPropertyTransitionSlow(VM& vm, Structure* structure, Tr
                 entry.attributes |= static_cast<unsigned>(PropertyAttribute::ReadOnly);
         }
     } else {
-        transition->setPropertyTable(vm, structure->takePropertyTableOrCloneIfPinned(vm));
+        // Taking the table of an unpinned Structure is already free. A pinned one must keep its
+        // table, so share it rather than cloning it if we can.
+        PropertyTable* table = structure->isPinnedPropertyTable() && Options::useSharedPropertyTables()
+            ? structure->sharePropertyTableForPinning(vm)
+            : structure->takePropertyTableOrCloneIfPinned(vm);
+        transition->setPropertyTable(vm, table);
         transition->setMaxOffset(vm, structure->maxOffset());
         checkOffset(transition->maxOffset(), transition->inlineCapacity());
     }
@@ -961,6 +993,10 @@ Structure* Structure::flattenDictionaryStructure(VM& vm, JSObject* object)
     if (isUncacheableDictionary()) {
         PropertyTable* table = propertyTableOrNull();
         ASSERT(table);
+        if (table->isShared()) {
+            table = PropertyTable::clone(vm, *table);
+            setPropertyTable(vm, table);
+        }
 
         size_t propertyCount = table->size();
 
@@ -1136,6 +1172,18 @@ PropertyTable* Structure::copyPropertyTableForPinning(VM& vm)
     return materializePropertyTable(vm, setPropertyTable);
 }
 
+PropertyTable* Structure::sharePropertyTableForPinning(VM& vm)
+{
+    if (!Options::useSharedPropertyTables())
+        return copyPropertyTableForPinning(vm);
+    if (PropertyTable* table = propertyTableOrNull()) {
+        table->setIsShared();
+        return table;
+    }
+    bool setPropertyTable = false;
+    return materializePropertyTable(vm, setPropertyTable);
+}
+
 PropertyOffset Structure::getConcurrently(UniquedStringImpl* uid, unsigned& attributes)
 {
     PropertyOffset result = invalidOffset;
@@ -188,6 +188,20 @@ public:
 
     static void dumpStatistics();
 
+    struct MemoryStatistics {
+        size_t totalBytes() const { return structureBytes + propertyTableBytes + rareDataBytes; }
+        double bytesPerStructure() const { return numberOfStructures ? static_cast<double>(totalBytes()) / numberOfStructures : 0; }
+
+        size_t numberOfStructures { 0 };
+        size_t numberOfPropertyTables { 0 };
+        size_t numberOfSharedPropertyTables { 0 };
+        size_t structureBytes { 0 };
+        size_t propertyTableBytes { 0 };
+        size_t rareDataBytes { 0 };
+    };
+    // Walks the live Structures. Property tables shared between Structures are only counted once.
+    JS_EXPORT_PRIVATE static MemoryStatistics memoryStatistics(VM&);
+
     JS_EXPORT_PRIVATE static Structure* addPropertyTransition(VM&, Structure*, PropertyName, unsigned attributes, PropertyOffset&);
     JS_EXPORT_PRIVATE static Structure* addNewPropertyTransition(VM&, Structure*, PropertyName, unsigned attributes, PropertyOffset&, PutPropertySlot::Context = PutPropertySlot::UnknownContext, DeferredStructureTransitionWatchpointFire* = nullptr);
     static Structure* addPropertyTransitionToExistingStructureConcurrently(Structure*, UniquedStringImpl* uid, unsigned attributes, PropertyOffset&);
@@ -769,6 +783,10 @@ private:
             return result;
         return materializePropertyTable(vm);
     }
+
+    // Like ensurePropertyTable(), but returns a private copy if the table is shared. The caller must
+    // install the result before modifying it. Do not call when holding the Structure's lock.
+    PropertyTable* ensureUnsharedPropertyTable(VM&);
     
     PropertyTable* propertyTableOrNull() const
     {
@@ -782,6 +800,7 @@ private:
     
     PropertyTable* takePropertyTableOrCloneIfPinned(VM&);
     PropertyTable* copyPropertyTableForPinning(VM&);
+    PropertyTable* sharePropertyTableForPinning(VM&);
 
     void setPreviousID(VM&, Structure*);
 
@@ -26,8 +26,10 @@
 #include "config.h"
 #include "StructureIDTable.h"
 
+#include "Options.h"
 #include <wtf/Atomics.h>
 #include <wtf/DataLog.h>
+#include <wtf/PageBlock.h>
 #include <wtf/RawPointer.h>
 
 namespace JSC {
@@ -38,11 +40,25 @@ namespace StructureIDTableInternal {
 static constexpr bool verbose = false;
 }
 
+// The number of entries in a page.
+static size_t commitGranule()
+{
+    return pageSize() / sizeof(void*);
+}
+
 StructureIDTable::StructureIDTable()
-    : m_table(makeUniqueArray<StructureOrOffset>(s_initialSize))
-    , m_size(1)
-    , m_capacity(s_initialSize)
+    : m_size(1)
+    , m_capacity(WTF::roundUpToMultipleOf(commitGranule(), s_initialSize))
 {
+    static_assert(sizeof(StructureOrOffset) == sizeof(void*));
+    // Reserving room for every representable ID costs 128MB of address space per VM, which adds up for
+    // clients that create many VMs. Let them ask for less.
+    m_maximumCapacity = std::min<size_t>(Options::maximumNumberOfStructureIDs(), s_maximumNumberOfStructures);
+    m_maximumCapacity = std::max(WTF::roundUpToMultipleOf(commitGranule(), m_maximumCapacity), m_capacity);
+    m_reservation = PageReservation::reserve(m_maximumCapacity * sizeof(StructureOrOffset), OSAllocator::UnknownUsage);
+    m_table = static_cast<StructureOrOffset*>(m_reservation.base());
+    m_reservation.commit(m_table, m_capacity * sizeof(StructureOrOffset));
+
     // We pre-allocate the first offset so that the null Structure
     // can still be represented as the StructureID '0'.
     table()[0].encodedStructureBits = 0;
@@ -50,6 +66,12 @@ StructureIDTable::StructureIDTable()
     makeFreeListFromRange(1, m_capacity - 1);
 }
 
+StructureIDTable::~StructureIDTable()
+{
+    m_reservation.decommit(m_table, m_capacity * sizeof(StructureOrOffset));
+    m_reservation.deallocate();
+}
+
 void StructureIDTable::makeFreeListFromRange(uint32_t first, uint32_t last)
 {
     ASSERT(!m_firstFreeOffset);
@@ -102,39 +124,24 @@ void StructureIDTable::makeFreeListFromRange(uint32_t first, uint32_t last)
     m_lastFreeOffset = tail;
 }
 
-void StructureIDTable::resize(size_t newCapacity)
+void StructureIDTable::grow()
 {
-    if (newCapacity > s_maximumNumberOfStructures)
-        newCapacity = s_maximumNumberOfStructures;
+    size_t newCapacity = std::min<size_t>(m_capacity + std::min(m_capacity, s_maximumGrowth), m_maximumCapacity);
 
-    // If m_size is already s_maximumNumberOfStructures, newCapacity becomes s_maximumNumberOfStructures in the above code.
-    // In that case, we should crash because of exhaust of StructureIDs.
+    // If m_capacity is already m_maximumCapacity, we have exhausted StructureIDs and
+    // should crash.
     RELEASE_ASSERT_WITH_MESSAGE(m_size < newCapacity, "Crash intentionally because of exhaust of StructureIDs.");
 
-    // Create the new table.
-    auto newTable = makeUniqueArray<StructureOrOffset>(newCapacity);
-
-    // Copy the contents of the old table to the new table.
-    memcpy(newTable.get(), table(), m_capacity * sizeof(StructureOrOffset));
+    // Both capacities are multiples of the commit granule, since m_maximumCapacity is rounded up to
+    // one and s_maximumGrowth is a power of two that is much larger than any page.
+    ASSERT(!(newCapacity % commitGranule()));
+    m_reservation.commit(m_table + m_capacity, (newCapacity - m_capacity) * sizeof(StructureOrOffset));
+    uint32_t first = m_capacity;
 
-    // Store fence to make sure we've copied everything before doing the swap.
+    // Make sure that the new entries are initialized before anyone can see that they are in bounds.
+    makeFreeListFromRange(first, newCapacity - 1);
     WTF::storeStoreFence();
-
-    // Swap the old and new tables.
-    swap(m_table, newTable);
-
-    // Put the old table (now labeled as new) into the list of old tables.
-    m_oldTables.append(WTFMove(newTable));
-
-    // Update the capacity.
     m_capacity = newCapacity;
-
-    makeFreeListFromRange(m_size, m_capacity - 1);
-}
-
-void StructureIDTable::flushOldTables()
-{
-    m_oldTables.clear();
 }
 
 StructureID StructureIDTable::allocateID(Structure* structure)
@@ -142,7 +149,7 @@ StructureID StructureIDTable::allocateID(Structure* structure)
     if (UNLIKELY(!m_firstFreeOffset)) {
         RELEASE_ASSERT(m_capacity <= s_maximumNumberOfStructures);
         ASSERT(m_size == m_capacity);
-        resize(m_capacity * 2);
+        grow();
         ASSERT(m_size < m_capacity);
         RELEASE_ASSERT(m_firstFreeOffset);
     }
@@ -27,8 +27,7 @@
 
 #include "EnsureStillAliveHere.h"
 #include "UnusedPointer.h"
-#include <wtf/UniqueArray.h>
-#include <wtf/Vector.h>
+#include <wtf/PageReservation.h>
 #include <wtf/WeakRandom.h>
 
 namespace JSC {
@@ -85,10 +84,16 @@ inline StructureID decontaminate(StructureID id)
 
 using EncodedStructureBits = uintptr_t;
 
+// The table lives in a virtual memory reservation that is big enough for
+// Options::maximumNumberOfStructureIDs() entries, and we commit more of it as we run out of IDs. So the
+// table never moves: concurrent readers and JIT code can always load it from base(), and growing
+// it never copies anything.
 class StructureIDTable {
+    WTF_MAKE_NONCOPYABLE(StructureIDTable);
     friend class LLIntOffsetsExtractor;
 public:
     StructureIDTable();
+    ~StructureIDTable();
 
     void** base() { return reinterpret_cast<void**>(&m_table); }
 
@@ -102,12 +107,10 @@ public:
     void deallocateID(Structure*, StructureID);
     StructureID allocateID(Structure*);
 
-    void flushOldTables();
-    
     size_t size() const { return m_size; }
 
 private:
-    void resize(size_t newCapacity);
+    void grow();
     void makeFreeListFromRange(uint32_t first, uint32_t last);
 
     union StructureOrOffset {
@@ -117,20 +120,23 @@ private:
         uintptr_t offset;
     };
 
-    StructureOrOffset* table() const { return m_table.get(); }
+    StructureOrOffset* table() const { return m_table; }
     static Structure* decode(EncodedStructureBits, StructureID);
     static EncodedStructureBits encode(Structure*, StructureID);
 
     static constexpr size_t s_initialSize = 512;
-
-    Vector<UniqueArray<StructureOrOffset>> m_oldTables;
+    // We commit at most this many more entries at a time, so the cost of growing the table does not
+    // depend on its size.
+    static constexpr size_t s_maximumGrowth = 1 << 14;
 
     uint32_t m_firstFreeOffset { 0 };
     uint32_t m_lastFreeOffset { 0 };
-    UniqueArray<StructureOrOffset> m_table;
+    StructureOrOffset* m_table { nullptr };
+    PageReservation m_reservation;
 
     size_t m_size { 0 };
     size_t m_capacity;
+    size_t m_maximumCapacity;
 
     WeakRandom m_weakRandom;
 
@@ -216,7 +222,6 @@ public:
         return structure;
     };
 
-    void flushOldTables() { }
     void validate(StructureID) { }
 };
 
@@ -446,7 +446,7 @@ inline void Structure::cacheSpecialProperty(JSGlobalObject* globalObject, VM& vm
 template<Structure::ShouldPin shouldPin, typename Func>
 inline PropertyOffset Structure::add(VM& vm, PropertyName propertyName, unsigned attributes, const Func& func)
 {
-    PropertyTable* table = ensurePropertyTable(vm);
+    PropertyTable* table = ensureUnsharedPropertyTable(vm);
 
     GCSafeConcurrentJSLocker locker(m_lock, vm.heap);
 
@@ -490,7 +490,7 @@ inline PropertyOffset Structure::add(VM& vm, PropertyName propertyName, unsigned
 template<Structure::ShouldPin shouldPin, typename Func>
 inline PropertyOffset Structure::remove(VM& vm, PropertyName propertyName, const Func& func)
 {
-    PropertyTable* table = ensurePropertyTable(vm);
+    PropertyTable* table = ensureUnsharedPropertyTable(vm);
     GCSafeConcurrentJSLocker locker(m_lock, vm.heap);
 
     switch (shouldPin) {
@@ -533,7 +533,7 @@ inline PropertyOffset Structure::remove(VM& vm, PropertyName propertyName, const
 template<Structure::ShouldPin shouldPin, typename Func>
 inline PropertyOffset Structure::attributeChange(VM& vm, PropertyName propertyName, unsigned attributes, const Func& func)
 {
-    PropertyTable* table = ensurePropertyTable(vm);
+    PropertyTable* table = ensureUnsharedPropertyTable(vm);
 
     GCSafeConcurrentJSLocker locker(m_lock, vm.heap);
 
@@ -606,6 +606,14 @@ ALWAYS_INLINE void Structure::setGlobalObject(VM& vm, JSGlobalObject* globalObje
     m_globalObject.set(vm, this, globalObject);
 }
 
+inline PropertyTable* Structure::ensureUnsharedPropertyTable(VM& vm)
+{
+    PropertyTable* table = ensurePropertyTable(vm);
+    if (UNLIKELY(table->isShared()))
+        return PropertyTable::clone(vm, *table);
+    return table;
+}
+
 ALWAYS_INLINE void Structure::setPropertyTable(VM& vm, PropertyTable* table)
 {
     m_propertyTableUnsafe.setMayBeNull(vm, this, table);
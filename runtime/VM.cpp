@@ -140,6 +140,7 @@
 #include "NativeExecutable.h"
 #include "NumberObject.h"
 #include "PredictionFileCreatingFuzzerAgent.h"
+#include "ProfileCache.h"
 #include "ProfilerDatabase.h"
 #include "ProgramCodeBlock.h"
 #include "ProgramExecutable.h"
@@ -547,6 +548,9 @@ VM::VM(VMType vmType, HeapType heapType, WTF::RunLoop* runLoop, bool* success)
     if (Options::useWideningNumberPredictionFuzzerAgent())
         setFuzzerAgent(makeUnique<WideningNumberPredictionFuzzerAgent>(*this));
 
+    if (Options::profileCacheFile())
+        m_profileCache = makeUnique<ProfileCache>(Options::profileCacheFile());
+
     if (Options::alwaysGeneratePCToCodeOriginMap())
         setShouldBuildPCToCodeOriginMapping();
 
@@ -624,6 +628,9 @@ VM::~VM()
         }
     }
 #endif // ENABLE(DFG_JIT)
+
+    if (m_profileCache)
+        m_profileCache->recordAndSave(*this);
     
     waitForAsynchronousDisassembly();
     
@@ -166,6 +166,7 @@ class LLIntOffsetsExtractor;
 class NativeExecutable;
 class ObjCCallbackFunction;
 class DeferredWorkTimer;
+class ProfileCache;
 class RegExp;
 class RegExpCache;
 class Register;
@@ -322,6 +323,8 @@ public:
         m_fuzzerAgent = WTFMove(fuzzerAgent);
     }
 
+    ProfileCache* profileCache() const { return m_profileCache.get(); }
+
     static unsigned numberOfIDs() { return s_numberOfIDs.load(); }
     unsigned id() const { return m_id; }
     bool isEntered() const { return !!entryScope; }
@@ -1220,6 +1223,7 @@ private:
     RefPtr<SamplingProfiler> m_samplingProfiler;
 #endif
     std::unique_ptr<FuzzerAgent> m_fuzzerAgent;
+    std::unique_ptr<ProfileCache> m_profileCache;
     std::unique_ptr<ShadowChicken> m_shadowChicken;
     std::unique_ptr<BytecodeIntrinsicRegistry> m_bytecodeIntrinsicRegistry;
 
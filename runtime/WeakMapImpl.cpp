@@ -28,6 +28,7 @@
 #include "WeakMapImpl.h"
 
 #include "AuxiliaryBarrierInlines.h"
+#include "EphemeronTable.h"
 #include "StructureInlines.h"
 #include "WeakMapImplInlines.h"
 
@@ -68,14 +69,26 @@ void WeakMapImpl<WeakMapBucket<WeakMapBucketDataKeyValue>>::visitOutputConstrain
     auto* thisObject = jsCast<WeakMapImpl*>(cell);
     auto locker = holdLock(thisObject->cellLock());
     auto* buffer = thisObject->buffer();
+
+    // Entries whose keys are not marked yet go into the heap's ephemeron index, so that marking
+    // the key marks the value right away. We only do this once per collection for each map.
+    bool shouldIndex = Options::useEphemeronIndex() && vm.heap.ephemeronTable().shouldIndex(thisObject);
+    Vector<std::pair<JSCell*, JSValue>> pendingEntries;
+
     for (uint32_t index = 0; index < thisObject->m_capacity; ++index) {
         auto* bucket = buffer + index;
         if (bucket->isEmpty() || bucket->isDeleted())
             continue;
-        if (!vm.heap.isMarked(bucket->key()))
+        if (!vm.heap.isMarked(bucket->key())) {
+            if (shouldIndex && bucket->value().isCell())
+                pendingEntries.append({ bucket->key(), bucket->value() });
             continue;
+        }
         bucket->visitAggregate(visitor);
     }
+
+    if (shouldIndex)
+        vm.heap.ephemeronTable().addPendingValues(pendingEntries);
 }
 
 template <typename WeakMapBucket>
@@ -33,15 +33,20 @@ CellProfile* CellList::find(HeapCell* cell)
     if (!size())
         return nullptr;
 
-    if (!m_mapIsUpToDate) {
-        m_map.clear();
-        for (auto& profile : m_cells)
-            m_map.add(profile.cell(), &profile);
-        m_mapIsUpToDate = true;
-    }
+    updateMapIfNeeded();
     return m_map.get(cell);
 }
 
+void CellList::updateMapIfNeeded()
+{
+    if (m_mapIsUpToDate)
+        return;
+    m_map.clear();
+    for (auto& profile : m_cells)
+        m_map.add(profile.cell(), &profile);
+    m_mapIsUpToDate = true;
+}
+
 void CellList::reset()
 {
     m_cells.clear();
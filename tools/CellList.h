@@ -55,6 +55,10 @@ public:
 
     CellProfile* find(HeapCell*);
 
+    // find() rebuilds its map lazily after the list changes. Call this first if find() is going to
+    // be called from more than one thread.
+    void updateMapIfNeeded();
+
 private:
     const char* m_name;
     CellProfileVector m_cells;
@@ -28,6 +28,8 @@
 
 #include "ButterflyInlines.h"
 #include "CodeBlockInlines.h"
+#include "HeapHelperPool.h"
+#include "Integrity.h"
 #include "JSObject.h"
 #include "MarkedSpaceInlines.h"
 #include "VMInspector.h"
@@ -40,6 +42,7 @@ HeapVerifier::HeapVerifier(Heap* heap, unsigned numberOfGCCyclesToRecord)
     : m_heap(heap)
     , m_currentCycle(0)
     , m_numberOfCycles(numberOfGCCyclesToRecord)
+    , m_helperClient(&heapHelperPool())
 {
     RELEASE_ASSERT(m_numberOfCycles > 0);
     m_cycles = makeUniqueArray<GCCycle>(m_numberOfCycles);
@@ -151,8 +154,10 @@ bool HeapVerifier::verifyCellList(Phase phase, CellList& list)
     VM& vm = m_heap->vm();
     auto& liveCells = list.cells();
 
+    // Only one thread at a time gets to report failures, so that each cell's report stays in one piece.
+    Lock reportLock;
     bool listNamePrinted = false;
-    auto printHeaderIfNeeded = scopedLambda<void()>([&] () {
+    auto printListHeaderIfNeeded = [&] () {
         if (listNamePrinted)
             return;
         
@@ -160,22 +165,48 @@ bool HeapVerifier::verifyCellList(Phase phase, CellList& list)
         dataLog(" @ phase ", phaseName(phase), ": FAILED in cell list '", list.name(), "' (size ", liveCells.size(), ")\n");
         listNamePrinted = true;
         m_didPrintLogs = true;
-    });
-    
-    bool success = true;
-    for (size_t i = 0; i < liveCells.size(); i++) {
-        CellProfile& profile = liveCells[i];
-        if (!profile.isLive())
-            continue;
-
-        if (!profile.isJSCell())
-            continue;
+    };
 
-        JSCell* cell = profile.jsCell();
-        success |= validateJSCell(&vm, cell, &profile, &list, printHeaderIfNeeded, "  ");
-    }
+    // validateJSCell() looks up structures in the list from all threads.
+    list.updateMapIfNeeded();
+
+    Integrity::CellSampler sampler(Options::heapAuditSampleRate());
+    size_t numberOfWorkUnits = (liveCells.size() + cellsPerWorkUnit - 1) / cellsPerWorkUnit;
+    Atomic<size_t> nextWorkUnit { 0 };
+    Atomic<bool> success { true };
+    m_helperClient.runFunctionInParallel([&] () {
+        for (size_t workUnit = nextWorkUnit.exchangeAdd(1); workUnit < numberOfWorkUnits; workUnit = nextWorkUnit.exchangeAdd(1)) {
+            size_t end = std::min(liveCells.size(), (workUnit + 1) * cellsPerWorkUnit);
+            for (size_t i = workUnit * cellsPerWorkUnit; i < end; i++) {
+                CellProfile& profile = liveCells[i];
+                if (!profile.isLive())
+                    continue;
+
+                if (!profile.isJSCell())
+                    continue;
+
+                if (!sampler.shouldSample(profile.cell()))
+                    continue;
+
+                bool holdsReportLock = false;
+                auto printHeaderIfNeeded = scopedLambda<void()>([&] () {
+                    if (!holdsReportLock) {
+                        reportLock.lock();
+                        holdsReportLock = true;
+                    }
+                    printListHeaderIfNeeded();
+                });
+
+                JSCell* cell = profile.jsCell();
+                if (!validateJSCell(&vm, cell, &profile, &list, printHeaderIfNeeded, "  "))
+                    success.store(false);
+                if (holdsReportLock)
+                    reportLock.unlock();
+            }
+        }
+    });
 
-    return success;
+    return success.load();
 }
 
 bool HeapVerifier::validateCell(HeapCell* cell, VM* expectedVM)
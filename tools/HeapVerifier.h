@@ -28,6 +28,7 @@
 #include "CellList.h"
 #include "Heap.h"
 #include <wtf/MonotonicTime.h>
+#include <wtf/ParallelHelperPool.h>
 #include <wtf/ScopedLambda.h>
 #include <wtf/UniqueArray.h>
 
@@ -107,11 +108,14 @@ private:
     void checkIfRecorded(HeapCell* maybeHeapCell);
     void reportCell(CellProfile&, int cycleIndex, HeapVerifier::GCCycle&, CellList&, const char* prefix = nullptr);
 
+    static constexpr size_t cellsPerWorkUnit = 256;
+
     Heap* m_heap;
     int m_currentCycle;
     int m_numberOfCycles;
     bool m_didPrintLogs { false };
     UniqueArray<GCCycle> m_cycles;
+    ParallelHelperClient m_helperClient;
 };
 
 } // namespace JSC
@@ -26,9 +26,14 @@
 #include "config.h"
 #include "Integrity.h"
 
+#include "HeapHelperPool.h"
 #include "JSCellInlines.h"
+#include "MarkedBlockInlines.h"
+#include "MarkedSpaceInlines.h"
 #include "Options.h"
 #include "VMInspectorInlines.h"
+#include <wtf/CryptographicallyRandomNumber.h>
+#include <wtf/ParallelHelperPool.h>
 
 namespace JSC {
 namespace Integrity {
@@ -67,11 +72,62 @@ bool Random::reloadAndCheckShouldAuditSlow(VM& vm)
     return vm.random().getUint32() <= threshold;
 }
 
+CellSampler::CellSampler(double rate)
+    : m_seed((static_cast<uint64_t>(cryptographicallyRandomNumber()) << 32) | cryptographicallyRandomNumber())
+    , m_threshold(UINT_MAX * std::clamp(rate, 0.0, 1.0))
+    , m_samplesEverything(rate >= 1)
+{
+}
+
 void auditCellFully(VM& vm, JSCell* cell)
 {
     VMInspector::verifyCell<VMInspector::ReleaseAssert>(vm, cell);
 }
 
+void auditHeap(VM& vm)
+{
+    MarkedSpace& objectSpace = vm.heap.objectSpace();
+
+    // Each block and each precise allocation is a work unit.
+    Vector<MarkedBlock::Handle*> blocks;
+    objectSpace.forEachBlock([&] (MarkedBlock::Handle* block) {
+        blocks.append(block);
+    });
+    const Vector<PreciseAllocation*>& preciseAllocations = objectSpace.preciseAllocations();
+    size_t numberOfWorkUnits = blocks.size() + preciseAllocations.size();
+
+    CellSampler sampler(Options::heapAuditSampleRate());
+    Atomic<size_t> numberOfAuditedCells { 0 };
+    auto auditIfSampled = [&] (HeapCell* cell, HeapCell::Kind kind) {
+        if (!isJSCellKind(kind) || !sampler.shouldSample(cell))
+            return;
+        auditCellFully(vm, static_cast<JSCell*>(cell));
+        if (verbose)
+            numberOfAuditedCells.exchangeAdd(1);
+    };
+
+    Atomic<size_t> nextWorkUnit { 0 };
+    ParallelHelperClient helperClient(&heapHelperPool());
+    helperClient.runFunctionInParallel([&] () {
+        for (size_t workUnit = nextWorkUnit.exchangeAdd(1); workUnit < numberOfWorkUnits; workUnit = nextWorkUnit.exchangeAdd(1)) {
+            if (workUnit < blocks.size()) {
+                blocks[workUnit]->forEachLiveCell([&] (size_t, HeapCell* cell, HeapCell::Kind kind) {
+                    auditIfSampled(cell, kind);
+                    return IterationStatus::Continue;
+                });
+                continue;
+            }
+
+            PreciseAllocation* allocation = preciseAllocations[workUnit - blocks.size()];
+            if (allocation->isLive())
+                auditIfSampled(allocation->cell(), allocation->attributes().cellKind);
+        }
+    });
+
+    if (verbose)
+        dataLogLn("audited ", numberOfAuditedCells.load(), " cells in ", blocks.size(), " blocks and ", preciseAllocations.size(), " precise allocations");
+}
+
 void auditCellMinimallySlow(VM&, JSCell* cell)
 {
     if (Gigacage::contains(cell)) {
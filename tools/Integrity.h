@@ -28,10 +28,12 @@
 #include "JSCJSValue.h"
 #include "StructureIDTable.h"
 #include <wtf/Gigacage.h>
+#include <wtf/HashFunctions.h>
 #include <wtf/Lock.h>
 
 namespace JSC {
 
+class HeapCell;
 class JSCell;
 class VM;
 
@@ -67,11 +69,34 @@ private:
     static constexpr int numberOfTriggerBits = (sizeof(m_triggerBits) * CHAR_BIT) - 1;
 };
 
+// Picks about rate of all cells, using a hash of their address. Cells that one sampler skips may
+// still be picked by the next one, since every sampler gets a new seed.
+class CellSampler {
+public:
+    JS_EXPORT_PRIVATE CellSampler(double rate);
+
+    bool shouldSample(HeapCell* cell) const
+    {
+        if (m_samplesEverything)
+            return true;
+        return WTF::intHash(static_cast<uint64_t>(bitwise_cast<uintptr_t>(cell)) ^ m_seed) < m_threshold;
+    }
+
+private:
+    uint64_t m_seed;
+    uint32_t m_threshold;
+    bool m_samplesEverything;
+};
+
 ALWAYS_INLINE void auditCellRandomly(VM&, JSCell*);
 ALWAYS_INLINE void auditCellMinimally(VM&, JSCell*);
 JS_EXPORT_PRIVATE void auditCellMinimallySlow(VM&, JSCell*);
 JS_EXPORT_PRIVATE void auditCellFully(VM&, JSCell*);
 
+// Fully audits a sample of the live cells in the heap (see Options::heapAuditSampleRate()), one
+// block at a time on the heap helper threads. The world must be stopped.
+JS_EXPORT_PRIVATE void auditHeap(VM&);
+
 template<AuditLevel = AuditLevel::Random, typename T>
 ALWAYS_INLINE void auditCell(VM&, T) { }
 